@@ -13,6 +13,28 @@
 #include <esp_matter.h>
 #include "bsp/esp-bsp.h"
 
+#if CONFIG_APP_SYNC_TRANSITIONS || CONFIG_APP_RENDER_TASK
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <sys/param.h>
+#endif
+
+#if CONFIG_APP_SYNC_TRANSITIONS
+#include <app_sync_tick.h>
+#include <esp_netif_sntp.h>
+#include <esp_sntp.h>
+#include <sys/time.h>
+#endif
+
+#if CONFIG_APP_RENDER_STRESS
+#include <crypto/CHIPCryptoPAL.h>
+#include <esp_matter_console.h>
+#include <lwip/sockets.h>
+#elif CONFIG_APP_RENDER_TASK && CONFIG_ENABLE_CHIP_SHELL
+#include <esp_matter_console.h>
+#endif
+
 #include <app_priv.h>
 
 using namespace chip::app::Clusters;
@@ -88,6 +110,571 @@ static esp_err_t app_driver_light_set_temperature(led_indicator_handle_t handle,
 #endif
 }
 
+static esp_err_t app_driver_light_apply(led_indicator_handle_t handle, uint32_t cluster_id, uint32_t attribute_id,
+                                        esp_matter_attr_val_t *val)
+{
+    esp_err_t err = ESP_OK;
+    if (cluster_id == OnOff::Id) {
+        if (attribute_id == OnOff::Attributes::OnOff::Id) {
+            err = app_driver_light_set_power(handle, val);
+        }
+    } else if (cluster_id == LevelControl::Id) {
+        if (attribute_id == LevelControl::Attributes::CurrentLevel::Id) {
+            err = app_driver_light_set_brightness(handle, val);
+        }
+    } else if (cluster_id == ColorControl::Id) {
+        if (attribute_id == ColorControl::Attributes::CurrentHue::Id) {
+            err = app_driver_light_set_hue(handle, val);
+        } else if (attribute_id == ColorControl::Attributes::CurrentSaturation::Id) {
+            err = app_driver_light_set_saturation(handle, val);
+        } else if (attribute_id == ColorControl::Attributes::ColorTemperatureMireds::Id) {
+            err = app_driver_light_set_temperature(handle, val);
+        }
+    }
+    return err;
+}
+
+#if CONFIG_APP_RENDER_TASK
+#define RENDER_FRAME_US ((int64_t)CONFIG_APP_RENDER_FRAME_MS * 1000)
+#define RENDER_JITTER_BUCKETS 5
+/* Render task notification bits: a frame release from the render timer, or updates to apply right away */
+#define RENDER_NOTIFY_FRAME (1u << 0)
+#define RENDER_NOTIFY_APPLY (1u << 1)
+
+typedef struct {
+    uint32_t cluster_id;
+    uint32_t attribute_id;
+} render_slot_t;
+
+/* One slot per rendered attribute, in the order they are applied within a frame */
+static const render_slot_t s_render_slots[] = {
+    {LevelControl::Id, LevelControl::Attributes::CurrentLevel::Id},
+    {ColorControl::Id, ColorControl::Attributes::CurrentHue::Id},
+    {ColorControl::Id, ColorControl::Attributes::CurrentSaturation::Id},
+    {ColorControl::Id, ColorControl::Attributes::ColorTemperatureMireds::Id},
+    {OnOff::Id, OnOff::Attributes::OnOff::Id},
+};
+#define RENDER_SLOT_COUNT (sizeof(s_render_slots) / sizeof(s_render_slots[0]))
+#define RENDER_SLOT_LEVEL 0
+
+/* Upper bounds of the start jitter histogram buckets, the last bucket is open ended */
+static const int64_t s_render_jitter_bounds_us[RENDER_JITTER_BUCKETS - 1] = {100, 1000, 5000, RENDER_FRAME_US};
+
+typedef struct {
+    uint32_t frames;
+    uint32_t rendered_frames;
+    uint32_t skipped_frames;
+    uint32_t deadline_misses;
+    int64_t jitter_sum_us;
+    int64_t jitter_max_us;
+    int64_t render_max_us;
+    uint32_t jitter_histogram[RENDER_JITTER_BUCKETS];
+} render_stats_t;
+
+/* Latest attribute values waiting for the next frame. Written by the Matter and esp_timer tasks,
+ * consumed by the render task. */
+static struct {
+    portMUX_TYPE lock;
+    TaskHandle_t task;
+    esp_timer_handle_t timer;
+    led_indicator_handle_t handle;
+    int64_t epoch_us; /* frame n is released at epoch_us + n * RENDER_FRAME_US */
+    volatile uint32_t released; /* frames released by the render timer, only written by its callback */
+    uint32_t pending;
+    uint32_t valid;
+    bool force;
+    esp_matter_attr_val_t values[RENDER_SLOT_COUNT];
+    render_stats_t stats;
+} s_render = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+/* Store the latest value of an attribute, to be rendered on the next frame if `pending` */
+static void app_driver_render_store(led_indicator_handle_t handle, uint32_t cluster_id, uint32_t attribute_id,
+                                    esp_matter_attr_val_t *val, bool pending)
+{
+    for (size_t i = 0; i < RENDER_SLOT_COUNT; i++) {
+        if (s_render_slots[i].cluster_id == cluster_id && s_render_slots[i].attribute_id == attribute_id) {
+            taskENTER_CRITICAL(&s_render.lock);
+            s_render.handle = handle;
+            s_render.values[i] = *val;
+            if (pending) {
+                s_render.pending |= 1u << i;
+            } else {
+                s_render.pending &= ~(1u << i);
+            }
+            s_render.valid |= 1u << i;
+            taskEXIT_CRITICAL(&s_render.lock);
+            break;
+        }
+    }
+}
+
+static esp_err_t app_driver_render_post(led_indicator_handle_t handle, uint32_t cluster_id, uint32_t attribute_id,
+                                        esp_matter_attr_val_t *val)
+{
+    app_driver_render_store(handle, cluster_id, attribute_id, val, true);
+    return ESP_OK;
+}
+
+#if CONFIG_APP_SYNC_TRANSITIONS
+/* Post the update and wake the render task right away instead of at the next frame, whose phase is
+ * unrelated to the caller's clock. Never blocks, so it is safe from esp_timer callbacks. */
+static esp_err_t app_driver_render_post_now(led_indicator_handle_t handle, uint32_t cluster_id,
+                                            uint32_t attribute_id, esp_matter_attr_val_t *val)
+{
+    app_driver_render_store(handle, cluster_id, attribute_id, val, true);
+    xTaskNotify(s_render.task, RENDER_NOTIFY_APPLY, eSetBits);
+    return ESP_OK;
+}
+#endif
+
+static void app_driver_render_timer_cb(void *arg)
+{
+    s_render.released++;
+    xTaskNotify(s_render.task, RENDER_NOTIFY_FRAME, eSetBits);
+}
+
+static void app_driver_render_task(void *arg)
+{
+    uint32_t frame = 0;
+    while (true) {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+        int64_t start_us = esp_timer_get_time();
+        /* More than one release means the previous frames were not started at all. None means this
+         * frame was already handled after an earlier wake-up. */
+        uint32_t releases = 0;
+        if (bits & RENDER_NOTIFY_FRAME) {
+            uint32_t released = s_render.released;
+            releases = released - frame;
+            frame = released;
+        }
+        int64_t release_us = s_render.epoch_us + (int64_t)frame * RENDER_FRAME_US;
+
+        esp_matter_attr_val_t values[RENDER_SLOT_COUNT];
+        taskENTER_CRITICAL(&s_render.lock);
+        uint32_t pending = s_render.pending;
+        if (s_render.force && releases) {
+            pending |= s_render.valid & (1u << RENDER_SLOT_LEVEL);
+        }
+        led_indicator_handle_t handle = s_render.handle;
+        memcpy(values, s_render.values, sizeof(values));
+        s_render.pending = 0;
+        taskEXIT_CRITICAL(&s_render.lock);
+
+        for (size_t i = 0; i < RENDER_SLOT_COUNT; i++) {
+            if (pending & (1u << i)) {
+                app_driver_light_apply(handle, s_render_slots[i].cluster_id, s_render_slots[i].attribute_id,
+                                       &values[i]);
+            }
+        }
+        /* Out of frame wake-ups only apply updates, they are not frames */
+        if (!releases) {
+            continue;
+        }
+
+        int64_t end_us = esp_timer_get_time();
+        int64_t jitter_us = start_us - release_us;
+        int bucket = 0;
+        while (bucket < RENDER_JITTER_BUCKETS - 1 && jitter_us >= s_render_jitter_bounds_us[bucket]) {
+            bucket++;
+        }
+        taskENTER_CRITICAL(&s_render.lock);
+        render_stats_t *stats = &s_render.stats;
+        stats->frames += releases;
+        stats->skipped_frames += releases - 1;
+        stats->deadline_misses += releases - 1 + (end_us > release_us + RENDER_FRAME_US ? 1 : 0);
+        stats->rendered_frames += pending ? 1 : 0;
+        stats->jitter_sum_us += jitter_us;
+        stats->jitter_max_us = MAX(stats->jitter_max_us, jitter_us);
+        stats->render_max_us = MAX(stats->render_max_us, end_us - start_us);
+        stats->jitter_histogram[bucket]++;
+        taskEXIT_CRITICAL(&s_render.lock);
+    }
+}
+
+/* Release whatever app_driver_render_start() created, so that updates are applied directly again */
+static void app_driver_render_cleanup()
+{
+    if (s_render.timer) {
+        esp_timer_delete(s_render.timer);
+        s_render.timer = NULL;
+    }
+    if (s_render.task) {
+        vTaskDelete(s_render.task);
+        s_render.task = NULL;
+    }
+}
+
+static esp_err_t app_driver_render_start(led_indicator_handle_t handle)
+{
+    s_render.handle = handle;
+    const esp_timer_create_args_t timer_args = {
+        .callback = app_driver_render_timer_cb,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "light_render",
+        .skip_unhandled_events = false,
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &s_render.timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create render timer, err:%d", err);
+        app_driver_render_cleanup();
+        return err;
+    }
+    if (xTaskCreate(app_driver_render_task, "light_render", CONFIG_APP_RENDER_TASK_STACK_SIZE, NULL,
+                    CONFIG_APP_RENDER_TASK_PRIORITY, &s_render.task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create render task");
+        app_driver_render_cleanup();
+        return ESP_ERR_NO_MEM;
+    }
+    s_render.epoch_us = esp_timer_get_time();
+    err = esp_timer_start_periodic(s_render.timer, RENDER_FRAME_US);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start render timer, err:%d", err);
+        app_driver_render_cleanup();
+    }
+    return err;
+}
+
+#if CONFIG_ENABLE_CHIP_SHELL
+static void app_driver_render_print_stats()
+{
+    render_stats_t stats;
+    taskENTER_CRITICAL(&s_render.lock);
+    stats = s_render.stats;
+    taskEXIT_CRITICAL(&s_render.lock);
+
+    printf("Render: frame %d ms, priority %u\n", CONFIG_APP_RENDER_FRAME_MS,
+           (unsigned)uxTaskPriorityGet(s_render.task));
+    printf("  frames            %lu (rendered %lu, skipped %lu)\n", (unsigned long)stats.frames,
+           (unsigned long)stats.rendered_frames, (unsigned long)stats.skipped_frames);
+    printf("  deadline misses   %lu\n", (unsigned long)stats.deadline_misses);
+    uint32_t started = stats.frames - stats.skipped_frames;
+    printf("  start jitter      avg %ld us, max %ld us\n", (long)(started ? stats.jitter_sum_us / started : 0),
+           (long)stats.jitter_max_us);
+    printf("  jitter histogram  <100us %lu, <1ms %lu, <5ms %lu, <frame %lu, >=frame %lu\n",
+           (unsigned long)stats.jitter_histogram[0], (unsigned long)stats.jitter_histogram[1],
+           (unsigned long)stats.jitter_histogram[2], (unsigned long)stats.jitter_histogram[3],
+           (unsigned long)stats.jitter_histogram[4]);
+    printf("  worst render time %ld us\n", (long)stats.render_max_us);
+}
+
+static void app_driver_render_reset_stats()
+{
+    taskENTER_CRITICAL(&s_render.lock);
+    memset(&s_render.stats, 0, sizeof(s_render.stats));
+    taskEXIT_CRITICAL(&s_render.lock);
+}
+
+#if CONFIG_APP_RENDER_STRESS
+#define STRESS_PBKDF2_ITERATIONS 10000
+#define STRESS_UDP_PORT 9
+
+static volatile bool s_stress_running = false;
+static volatile uint32_t s_stress_pbkdf2_runs = 0;
+static volatile uint32_t s_stress_packets = 0;
+
+static void app_driver_stress_pbkdf2_task(void *arg)
+{
+    static const uint8_t salt[chip::Crypto::kSpake2p_Max_PBKDF_Salt_Length] = {0};
+    while (s_stress_running) {
+        chip::Crypto::Spake2pVerifier verifier;
+        verifier.Generate(STRESS_PBKDF2_ITERATIONS, chip::ByteSpan(salt), 20202021);
+        s_stress_pbkdf2_runs++;
+        /* Let the idle task run so the task watchdog stays quiet */
+        vTaskDelay(1);
+    }
+    xTaskNotifyGive((TaskHandle_t)arg);
+    vTaskDelete(NULL);
+}
+
+static void app_driver_stress_network_task(void *arg)
+{
+    static uint8_t payload[1024];
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    int broadcast = 1;
+    setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast));
+    struct sockaddr_in dest = {};
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(STRESS_UDP_PORT);
+    dest.sin_addr.s_addr = htonl(INADDR_BROADCAST);
+
+    while (s_stress_running && sock >= 0) {
+        if (sendto(sock, payload, sizeof(payload), 0, (struct sockaddr *)&dest, sizeof(dest)) < 0) {
+            vTaskDelay(1);
+        } else if (++s_stress_packets % 8 == 0) {
+            vTaskDelay(1);
+        }
+    }
+    if (sock >= 0) {
+        close(sock);
+    } else {
+        ESP_LOGE(TAG, "Failed to create stress socket");
+    }
+    xTaskNotifyGive((TaskHandle_t)arg);
+    vTaskDelete(NULL);
+}
+
+static void app_driver_stress_task(void *arg)
+{
+    uint32_t seconds = (uint32_t)(uintptr_t)arg;
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    int workers = 0;
+
+    app_driver_render_reset_stats();
+    s_stress_pbkdf2_runs = 0;
+    s_stress_packets = 0;
+    s_stress_running = true;
+    s_render.force = true;
+    if (xTaskCreate(app_driver_stress_pbkdf2_task, "stress_pbkdf2", 8192, self, CONFIG_APP_RENDER_STRESS_PRIORITY,
+                    NULL) == pdPASS) {
+        workers++;
+    }
+    if (xTaskCreate(app_driver_stress_network_task, "stress_net", 3072, self, CONFIG_APP_RENDER_STRESS_PRIORITY,
+                    NULL) == pdPASS) {
+        workers++;
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(seconds * 1000));
+    s_stress_running = false;
+    while (workers-- > 0) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+    s_render.force = false;
+
+    printf("Render stress: %lu s, PBKDF2 runs %lu, UDP packets %lu, stress priority %d\n", (unsigned long)seconds,
+           (unsigned long)s_stress_pbkdf2_runs, (unsigned long)s_stress_packets, CONFIG_APP_RENDER_STRESS_PRIORITY);
+    app_driver_render_print_stats();
+    vTaskDelete(NULL);
+}
+#endif // CONFIG_APP_RENDER_STRESS
+
+static esp_err_t app_driver_render_command_handler(int argc, char **argv)
+{
+    if (!s_render.task) {
+        printf("Render task not running\n");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (argc == 0 || (argc == 1 && strcmp(argv[0], "stats") == 0)) {
+        app_driver_render_print_stats();
+        return ESP_OK;
+    }
+    if (argc == 1 && strcmp(argv[0], "reset") == 0) {
+        app_driver_render_reset_stats();
+        return ESP_OK;
+    }
+    if (argc == 2 && strcmp(argv[0], "priority") == 0) {
+        int priority = atoi(argv[1]);
+        if (priority < 1 || priority >= configMAX_PRIORITIES) {
+            printf("Priority must be 1-%d\n", configMAX_PRIORITIES - 1);
+            return ESP_ERR_INVALID_ARG;
+        }
+        vTaskPrioritySet(s_render.task, priority);
+        app_driver_render_reset_stats();
+        return ESP_OK;
+    }
+#if CONFIG_APP_RENDER_STRESS
+    if (argc == 2 && strcmp(argv[0], "stress") == 0) {
+        int seconds = atoi(argv[1]);
+        if (s_stress_running || seconds <= 0) {
+            printf("Stress test already running or invalid duration\n");
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (xTaskCreate(app_driver_stress_task, "stress", 3072, (void *)(uintptr_t)seconds,
+                        CONFIG_APP_RENDER_STRESS_PRIORITY + 1, NULL) != pdPASS) {
+            return ESP_FAIL;
+        }
+        return ESP_OK;
+    }
+#endif
+    printf("Usage: matter esp render [stats|reset|priority <n>|stress <seconds>]\n");
+    return ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t app_driver_render_register_commands()
+{
+    static const esp_matter::console::command_t command = {
+        .name = "render",
+        .description = "LED render loop statistics. "
+                       "Usage: matter esp render [stats|reset|priority <n>|stress <seconds>]",
+        .handler = app_driver_render_command_handler,
+    };
+    return esp_matter::console::add_commands(&command, 1);
+}
+#endif // CONFIG_ENABLE_CHIP_SHELL
+#endif // CONFIG_APP_RENDER_TASK
+
+/* Hand the update to the render task when there is one, otherwise drive the LED right away */
+static esp_err_t app_driver_light_submit(led_indicator_handle_t handle, uint32_t cluster_id, uint32_t attribute_id,
+                                         esp_matter_attr_val_t *val)
+{
+#if CONFIG_APP_RENDER_TASK
+    if (s_render.task) {
+        return app_driver_render_post(handle, cluster_id, attribute_id, val);
+    }
+#endif
+    return app_driver_light_apply(handle, cluster_id, attribute_id, val);
+}
+
+/* Remember a value driven outside the render task, so that re-rendered frames start from it */
+static void app_driver_light_seed(led_indicator_handle_t handle, uint32_t cluster_id, uint32_t attribute_id,
+                                  esp_matter_attr_val_t *val)
+{
+#if CONFIG_APP_RENDER_TASK
+    app_driver_render_store(handle, cluster_id, attribute_id, val, false);
+#endif
+}
+
+#if CONFIG_APP_SYNC_TRANSITIONS
+/* Updates released on a tick boundary wake the render task right away instead of waiting for the next
+ * frame, which would add up to one frame of per-light delay and break the alignment across the group */
+static esp_err_t app_driver_light_submit_now(led_indicator_handle_t handle, uint32_t cluster_id,
+                                             uint32_t attribute_id, esp_matter_attr_val_t *val)
+{
+#if CONFIG_APP_RENDER_TASK
+    if (s_render.task) {
+        return app_driver_render_post_now(handle, cluster_id, attribute_id, val);
+    }
+#endif
+    return app_driver_light_apply(handle, cluster_id, attribute_id, val);
+}
+
+#define SYNC_TICK_US ((int64_t)CONFIG_APP_SYNC_TICK_MS * 1000)
+/* An update arriving after this much idle time is treated as the start of a new transition */
+#define SYNC_IDLE_US (4 * SYNC_TICK_US)
+
+/* Updates waiting for the next tick boundary of the reference clock. Written from the Matter task,
+ * applied from the esp_timer task. */
+static struct {
+    portMUX_TYPE lock;
+    esp_timer_handle_t timer;
+    bool clock_valid;
+    int64_t offset_us; /* reference time - esp_timer time */
+    led_indicator_handle_t handle;
+    bool power_pending;
+    bool level_pending;
+    esp_matter_attr_val_t power;
+    esp_matter_attr_val_t level;
+    int64_t boundary_us; /* reference time the pending updates are applied at */
+    int64_t last_apply_us;
+} s_sync = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+static void app_driver_sync_time_cb(struct timeval *tv)
+{
+    int64_t offset_us = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec - esp_timer_get_time();
+    taskENTER_CRITICAL(&s_sync.lock);
+    int64_t step_us = s_sync.clock_valid ? offset_us - s_sync.offset_us : 0;
+    s_sync.offset_us = offset_us;
+    s_sync.clock_valid = true;
+    taskEXIT_CRITICAL(&s_sync.lock);
+#if CONFIG_APP_SYNC_MEASURE
+    ESP_LOGI(TAG, "sync: reference clock updated, offset %lld us, step %lld us", offset_us, step_us);
+#else
+    (void)step_us;
+#endif
+}
+
+static void app_driver_sync_timer_cb(void *arg)
+{
+    taskENTER_CRITICAL(&s_sync.lock);
+    int64_t now_us = esp_timer_get_time() + s_sync.offset_us;
+    int64_t boundary_us = s_sync.boundary_us;
+    bool transition_start = now_us - s_sync.last_apply_us > SYNC_IDLE_US;
+    bool power_pending = s_sync.power_pending;
+    bool level_pending = s_sync.level_pending;
+    esp_matter_attr_val_t power = s_sync.power;
+    esp_matter_attr_val_t level = s_sync.level;
+    s_sync.power_pending = false;
+    s_sync.level_pending = false;
+    s_sync.last_apply_us = now_us;
+    taskEXIT_CRITICAL(&s_sync.lock);
+
+    if (level_pending) {
+        app_driver_light_submit_now(s_sync.handle, LevelControl::Id, LevelControl::Attributes::CurrentLevel::Id,
+                                    &level);
+    }
+    if (power_pending) {
+        app_driver_light_submit_now(s_sync.handle, OnOff::Id, OnOff::Attributes::OnOff::Id, &power);
+    }
+#if CONFIG_APP_SYNC_MEASURE
+    if (transition_start) {
+        ESP_LOGI(TAG, "sync: transition start at reference %lld us, skew %lld us", boundary_us,
+                 esp_timer_get_time() + s_sync.offset_us - boundary_us);
+    }
+#else
+    (void)boundary_us;
+    (void)transition_start;
+#endif
+}
+
+/* Queue the update for the next tick boundary. Returns false when the reference clock is not synced yet
+ * and the update should be applied immediately. */
+static bool app_driver_sync_defer(led_indicator_handle_t handle, uint32_t cluster_id, esp_matter_attr_val_t *val)
+{
+    if (!s_sync.timer) {
+        return false;
+    }
+    taskENTER_CRITICAL(&s_sync.lock);
+    if (!s_sync.clock_valid) {
+        taskEXIT_CRITICAL(&s_sync.lock);
+        return false;
+    }
+    s_sync.handle = handle;
+    if (cluster_id == OnOff::Id) {
+        s_sync.power = *val;
+        s_sync.power_pending = true;
+    } else {
+        s_sync.level = *val;
+        s_sync.level_pending = true;
+    }
+    bool schedule = !esp_timer_is_active(s_sync.timer);
+    int64_t delay_us = 0;
+    if (schedule) {
+        int64_t now_us = esp_timer_get_time();
+        int64_t fire_us = app_sync_next_local_boundary(now_us, s_sync.offset_us, SYNC_TICK_US);
+        s_sync.boundary_us = fire_us + s_sync.offset_us;
+        delay_us = fire_us - now_us;
+    }
+    taskEXIT_CRITICAL(&s_sync.lock);
+
+    if (schedule) {
+        esp_timer_start_once(s_sync.timer, delay_us);
+    }
+    return true;
+}
+
+esp_err_t app_driver_sync_init()
+{
+    const esp_timer_create_args_t timer_args = {
+        .callback = app_driver_sync_timer_cb,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "light_sync",
+        .skip_unhandled_events = true,
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &s_sync.timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create sync timer, err:%d", err);
+        return err;
+    }
+
+    /* Crystal drift between lights grows with the time since the last sync, resync often enough to keep
+     * it well below one tick */
+    esp_sntp_set_sync_interval(CONFIG_APP_SYNC_SNTP_INTERVAL_S * 1000);
+    esp_sntp_config_t sntp_config = ESP_NETIF_SNTP_DEFAULT_CONFIG(CONFIG_APP_SYNC_SNTP_SERVER);
+    sntp_config.sync_cb = app_driver_sync_time_cb;
+    err = esp_netif_sntp_init(&sntp_config);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start SNTP, err:%d", err);
+    }
+    return err;
+}
+#endif // CONFIG_APP_SYNC_TRANSITIONS
+
 static void app_driver_button_toggle_cb(void *arg, void *data)
 {
     ESP_LOGI(TAG, "Toggle button pressed");
@@ -109,23 +696,15 @@ esp_err_t app_driver_attribute_update(app_driver_handle_t driver_handle, uint16_
     esp_err_t err = ESP_OK;
     if (endpoint_id == light_endpoint_id) {
         led_indicator_handle_t handle = (led_indicator_handle_t)driver_handle;
-        if (cluster_id == OnOff::Id) {
-            if (attribute_id == OnOff::Attributes::OnOff::Id) {
-                err = app_driver_light_set_power(handle, val);
-            }
-        } else if (cluster_id == LevelControl::Id) {
-            if (attribute_id == LevelControl::Attributes::CurrentLevel::Id) {
-                err = app_driver_light_set_brightness(handle, val);
-            }
-        } else if (cluster_id == ColorControl::Id) {
-            if (attribute_id == ColorControl::Attributes::CurrentHue::Id) {
-                err = app_driver_light_set_hue(handle, val);
-            } else if (attribute_id == ColorControl::Attributes::CurrentSaturation::Id) {
-                err = app_driver_light_set_saturation(handle, val);
-            } else if (attribute_id == ColorControl::Attributes::ColorTemperatureMireds::Id) {
-                err = app_driver_light_set_temperature(handle, val);
+#if CONFIG_APP_SYNC_TRANSITIONS
+        if ((cluster_id == OnOff::Id && attribute_id == OnOff::Attributes::OnOff::Id) ||
+            (cluster_id == LevelControl::Id && attribute_id == LevelControl::Attributes::CurrentLevel::Id)) {
+            if (app_driver_sync_defer(handle, cluster_id, val)) {
+                return ESP_OK;
             }
         }
+#endif
+        err = app_driver_light_submit(handle, cluster_id, attribute_id, val);
     }
     return err;
 }
@@ -141,6 +720,7 @@ esp_err_t app_driver_light_set_defaults(uint16_t endpoint_id)
     attribute_t *attribute = attribute::get(endpoint_id, LevelControl::Id, LevelControl::Attributes::CurrentLevel::Id);
     attribute::get_val(attribute, &val);
     err |= app_driver_light_set_brightness(handle, &val);
+    app_driver_light_seed(handle, LevelControl::Id, LevelControl::Attributes::CurrentLevel::Id, &val);
 
     /* Setting color */
     attribute = attribute::get(endpoint_id, ColorControl::Id, ColorControl::Attributes::ColorMode::Id);
@@ -150,15 +730,18 @@ esp_err_t app_driver_light_set_defaults(uint16_t endpoint_id)
         attribute = attribute::get(endpoint_id, ColorControl::Id, ColorControl::Attributes::CurrentHue::Id);
         attribute::get_val(attribute, &val);
         err |= app_driver_light_set_hue(handle, &val);
+        app_driver_light_seed(handle, ColorControl::Id, ColorControl::Attributes::CurrentHue::Id, &val);
         /* Setting saturation */
         attribute = attribute::get(endpoint_id, ColorControl::Id, ColorControl::Attributes::CurrentSaturation::Id);
         attribute::get_val(attribute, &val);
         err |= app_driver_light_set_saturation(handle, &val);
+        app_driver_light_seed(handle, ColorControl::Id, ColorControl::Attributes::CurrentSaturation::Id, &val);
     } else if (val.val.u8 == (uint8_t)ColorControl::ColorMode::kColorTemperature) {
         /* Setting temperature */
         attribute = attribute::get(endpoint_id, ColorControl::Id, ColorControl::Attributes::ColorTemperatureMireds::Id);
         attribute::get_val(attribute, &val);
         err |= app_driver_light_set_temperature(handle, &val);
+        app_driver_light_seed(handle, ColorControl::Id, ColorControl::Attributes::ColorTemperatureMireds::Id, &val);
     } else {
         ESP_LOGE(TAG, "Color mode not supported");
     }
@@ -167,6 +750,7 @@ esp_err_t app_driver_light_set_defaults(uint16_t endpoint_id)
     attribute = attribute::get(endpoint_id, OnOff::Id, OnOff::Attributes::OnOff::Id);
     attribute::get_val(attribute, &val);
     err |= app_driver_light_set_power(handle, &val);
+    app_driver_light_seed(handle, OnOff::Id, OnOff::Attributes::OnOff::Id, &val);
 
     return err;
 }
@@ -178,11 +762,19 @@ app_driver_handle_t app_driver_light_init()
     led_indicator_handle_t leds[CONFIG_BSP_LEDS_NUM];
     ESP_ERROR_CHECK(bsp_led_indicator_create(leds, NULL, CONFIG_BSP_LEDS_NUM));
     led_indicator_set_hsv(leds[0], SET_HSV(DEFAULT_HUE, DEFAULT_SATURATION, DEFAULT_BRIGHTNESS));
-    
-    return (app_driver_handle_t)leds[0];
+    led_indicator_handle_t handle = leds[0];
 #else
-    return NULL;
+    led_indicator_handle_t handle = NULL;
 #endif
+#if CONFIG_APP_RENDER_TASK
+    /* Without the render task, updates are applied directly from the caller's context */
+    esp_err_t err = app_driver_render_start(handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start render task, applying updates directly, err:%d", err);
+    }
+#endif
+
+    return (app_driver_handle_t)handle;
 }
 
 app_driver_handle_t app_driver_button_init()
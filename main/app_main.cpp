@@ -24,6 +24,7 @@
 #include <esp_matter_providers.h>
 
 #include <app_priv.h>
+#include <app_profiler.h>
 #include <app_reset.h>
 #include <common_macros.h>
 #include <driver/gpio.h>
@@ -34,6 +35,7 @@
 #include <app/server/CommissioningWindowManager.h>
 #include <app/server/Server.h>
 #include <custom_provider/dynamic_commissionable_data_provider.h>
+#include <custom_provider/factory_partition_commissionable_data_provider.h>
 
 static const char *TAG = "app_main";
 uint16_t light_endpoint_id = 0;
@@ -43,7 +45,9 @@ uint16_t light_endpoint_id = 0;
 #define WIFI_PASS CONFIG_EXAMPLE_WIFI_PASSWORD
 #define WIFI_MAXIMUM_RETRY 10
 
-#if CONFIG_DYNAMIC_PASSCODE_COMMISSIONABLE_DATA_PROVIDER
+#if CONFIG_FACTORY_PARTITION_COMMISSIONABLE_DATA_PROVIDER
+factory_partition_commissionable_data_provider g_dynamic_passcode_provider;
+#elif CONFIG_DYNAMIC_PASSCODE_COMMISSIONABLE_DATA_PROVIDER
 dynamic_commissionable_data_provider g_dynamic_passcode_provider;
 #endif
 
@@ -140,26 +144,36 @@ static void app_event_cb(const ChipDeviceEvent *event, intptr_t arg)
 
     case chip::DeviceLayer::DeviceEventType::kCommissioningComplete:
         ESP_LOGI(TAG, "Commissioning complete");
+        app_profiler_record(APP_PROFILER_COMMISSIONING_COMPLETE);
+#if CONFIG_USE_BLE_ONLY_FOR_COMMISSIONING
+        /* esp-matter schedules the BLE deinit from this event, so BLE still holds its memory here */
+        app_profiler_record(APP_PROFILER_BEFORE_BLE_DEINIT);
+#endif
         break;
 
     case chip::DeviceLayer::DeviceEventType::kFailSafeTimerExpired:
         ESP_LOGI(TAG, "Commissioning failed, fail safe timer expired");
+        app_profiler_record(APP_PROFILER_FAIL_SAFE_EXPIRED);
         break;
 
     case chip::DeviceLayer::DeviceEventType::kCommissioningSessionStarted:
         ESP_LOGI(TAG, "Commissioning session started");
+        app_profiler_record(APP_PROFILER_SESSION_STARTED);
         break;
 
     case chip::DeviceLayer::DeviceEventType::kCommissioningSessionStopped:
         ESP_LOGI(TAG, "Commissioning session stopped");
+        app_profiler_record(APP_PROFILER_SESSION_STOPPED);
         break;
 
     case chip::DeviceLayer::DeviceEventType::kCommissioningWindowOpened:
         ESP_LOGI(TAG, "Commissioning window opened");
+        app_profiler_record(APP_PROFILER_WINDOW_OPENED);
         break;
 
     case chip::DeviceLayer::DeviceEventType::kCommissioningWindowClosed:
         ESP_LOGI(TAG, "Commissioning window closed");
+        app_profiler_record(APP_PROFILER_WINDOW_CLOSED);
         break;
 
     case chip::DeviceLayer::DeviceEventType::kFabricRemoved: {
@@ -192,10 +206,22 @@ static void app_event_cb(const ChipDeviceEvent *event, intptr_t arg)
 
     case chip::DeviceLayer::DeviceEventType::kFabricCommitted:
         ESP_LOGI(TAG, "Fabric is committed");
+        app_profiler_record(APP_PROFILER_FABRIC_COMMITTED);
         break;
 
     case chip::DeviceLayer::DeviceEventType::kBLEDeinitialized:
         ESP_LOGI(TAG, "BLE deinitialized and memory reclaimed");
+        app_profiler_record(APP_PROFILER_BLE_DEINITIALIZED);
+        break;
+
+    case chip::DeviceLayer::DeviceEventType::kCHIPoBLEConnectionEstablished:
+        ESP_LOGI(TAG, "CHIPoBLE connection established");
+        app_profiler_record(APP_PROFILER_BLE_CONNECTED);
+        break;
+
+    case chip::DeviceLayer::DeviceEventType::kCHIPoBLEConnectionClosed:
+        ESP_LOGI(TAG, "CHIPoBLE connection closed");
+        app_profiler_record(APP_PROFILER_BLE_DISCONNECTED);
         break;
 
     default:
@@ -239,6 +265,11 @@ extern "C" void app_main()
     /* Initialize WiFi connection */
     wifi_init_sta();
 
+#if CONFIG_APP_SYNC_TRANSITIONS
+    /* Reference clock for synchronized group transitions */
+    app_driver_sync_init();
+#endif
+
     /* Initialize driver */
     app_driver_handle_t light_handle = app_driver_light_init();
     app_driver_handle_t button_handle = app_driver_button_init();
@@ -327,6 +358,10 @@ extern "C" void app_main()
     esp_matter::console::diagnostics_register_commands();
     // esp_matter::console::wifi_register_commands();
     esp_matter::console::factoryreset_register_commands();
+    app_profiler_register_commands();
+#if CONFIG_APP_RENDER_TASK
+    app_driver_render_register_commands();
+#endif
 #if CONFIG_OPENTHREAD_CLI
     esp_matter::console::otcli_register_commands();
 #endif
@@ -80,6 +80,30 @@ esp_err_t app_driver_attribute_update(app_driver_handle_t driver_handle, uint16_
  */
 esp_err_t app_driver_light_set_defaults(uint16_t endpoint_id);
 
+#if CONFIG_APP_SYNC_TRANSITIONS
+/** Start synchronized transitions
+ *
+ * Starts SNTP against the configured reference server. Once the clock is synced, OnOff and
+ * CurrentLevel updates are applied on the next common tick boundary. Needs network connectivity.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t app_driver_sync_init();
+#endif
+
+#if CONFIG_APP_RENDER_TASK && CONFIG_ENABLE_CHIP_SHELL
+/** Register the render task shell commands
+ *
+ * Adds `matter esp render` to show and reset the render loop statistics, change the render task
+ * priority and run the stress mode.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t app_driver_render_register_commands();
+#endif
+
 #if CHIP_DEVICE_CONFIG_ENABLE_THREAD
 #define ESP_OPENTHREAD_DEFAULT_RADIO_CONFIG()                                           \
     {                                                                                   \
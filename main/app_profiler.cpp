@@ -0,0 +1,183 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#include <app_profiler.h>
+
+#if CONFIG_APP_COMMISSIONING_PROFILER
+
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <stdio.h>
+#include <string.h>
+
+#if CONFIG_ENABLE_CHIP_SHELL
+#include <esp_matter_console.h>
+#endif
+
+#define TIMELINE_COUNT CONFIG_APP_COMMISSIONING_PROFILER_TIMELINES
+#define TIMELINE_EVENTS CONFIG_APP_COMMISSIONING_PROFILER_EVENTS
+
+typedef struct {
+    int64_t time_us;
+    uint32_t free_heap;
+    uint8_t event;
+} profiler_entry_t;
+
+typedef struct {
+    uint32_t id;
+    uint8_t count;
+    bool window_opened;
+    profiler_entry_t entries[TIMELINE_EVENTS];
+} profiler_timeline_t;
+
+static const char *s_event_names[APP_PROFILER_EVENT_MAX] = {
+    "GetSetupPasscode",
+    "GetSpake2pVerifier begin",
+    "GetSpake2pVerifier end",
+    "Commissioning window opened",
+    "BLE connected",
+    "Commissioning session started",
+    "Commissioning session stopped",
+    "Fabric committed",
+    "Commissioning complete",
+    "Fail safe timer expired",
+    "Commissioning window closed",
+    "BLE disconnected",
+    "Before BLE deinit",
+    "BLE deinitialized",
+};
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static profiler_timeline_t s_timelines[TIMELINE_COUNT];
+static uint32_t s_timeline_count = 0;
+
+static profiler_timeline_t *current_timeline()
+{
+    return s_timeline_count ? &s_timelines[(s_timeline_count - 1) % TIMELINE_COUNT] : NULL;
+}
+
+static profiler_timeline_t *start_timeline()
+{
+    profiler_timeline_t *timeline = &s_timelines[s_timeline_count % TIMELINE_COUNT];
+    memset(timeline, 0, sizeof(*timeline));
+    timeline->id = s_timeline_count++;
+    return timeline;
+}
+
+void app_profiler_record(app_profiler_event_t event)
+{
+    profiler_entry_t entry = {
+        .time_us = esp_timer_get_time(),
+        .free_heap = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_DEFAULT),
+        .event = (uint8_t)event,
+    };
+
+    taskENTER_CRITICAL(&s_lock);
+    profiler_timeline_t *timeline = current_timeline();
+    /* The verifier is computed right before the window is announced, so either one begins a new
+     * attempt once the current timeline has seen its window. */
+    bool opens_window = event == APP_PROFILER_GET_VERIFIER_BEGIN || event == APP_PROFILER_WINDOW_OPENED;
+    if (!timeline || (opens_window && timeline->window_opened)) {
+        timeline = start_timeline();
+    }
+    if (event == APP_PROFILER_WINDOW_OPENED) {
+        timeline->window_opened = true;
+    }
+    if (timeline->count < TIMELINE_EVENTS) {
+        timeline->entries[timeline->count++] = entry;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+}
+
+#if CONFIG_ENABLE_CHIP_SHELL
+static void dump_timeline(const profiler_timeline_t *timeline)
+{
+    if (timeline->count == 0) {
+        return;
+    }
+    const profiler_entry_t *first = &timeline->entries[0];
+    const profiler_entry_t *last = &timeline->entries[timeline->count - 1];
+    printf("Commissioning timeline #%lu: %u events, %ld ms total\n", (unsigned long)timeline->id, timeline->count,
+           (long)((last->time_us - first->time_us) / 1000));
+    printf("  %10s %10s %10s %8s  %s\n", "t (ms)", "phase (ms)", "heap (B)", "dheap", "event");
+
+    int64_t verifier_begin_us = -1;
+    const profiler_entry_t *before_deinit = NULL;
+    for (int i = 0; i < timeline->count; i++) {
+        const profiler_entry_t *entry = &timeline->entries[i];
+        const profiler_entry_t *prev = i > 0 ? &timeline->entries[i - 1] : entry;
+        printf("  %10ld %10ld %10lu %+8ld  %s\n", (long)((entry->time_us - first->time_us) / 1000),
+               (long)((entry->time_us - prev->time_us) / 1000), (unsigned long)entry->free_heap,
+               (long)entry->free_heap - (long)prev->free_heap, s_event_names[entry->event]);
+        if (entry->event == APP_PROFILER_GET_VERIFIER_BEGIN) {
+            verifier_begin_us = entry->time_us;
+        } else if (entry->event == APP_PROFILER_GET_VERIFIER_END && verifier_begin_us >= 0) {
+            printf("  %10s %10ld %10s %8s  (verifier generation)\n", "",
+                   (long)((entry->time_us - verifier_begin_us) / 1000), "", "");
+        } else if (entry->event == APP_PROFILER_BEFORE_BLE_DEINIT) {
+            before_deinit = entry;
+        } else if (entry->event == APP_PROFILER_BLE_DEINITIALIZED && before_deinit) {
+            printf("  %10s %10ld %10s %+8ld  (heap reclaimed by BLE deinit)\n", "",
+                   (long)((entry->time_us - before_deinit->time_us) / 1000), "",
+                   (long)entry->free_heap - (long)before_deinit->free_heap);
+        }
+    }
+    if (timeline->count == TIMELINE_EVENTS) {
+        printf("  (timeline full, later events dropped)\n");
+    }
+}
+
+static esp_err_t app_profiler_command_handler(int argc, char **argv)
+{
+    if (argc == 1 && strcmp(argv[0], "clear") == 0) {
+        taskENTER_CRITICAL(&s_lock);
+        memset(s_timelines, 0, sizeof(s_timelines));
+        s_timeline_count = 0;
+        taskEXIT_CRITICAL(&s_lock);
+        return ESP_OK;
+    }
+    if (argc > 1 || (argc == 1 && strcmp(argv[0], "dump") != 0)) {
+        printf("Usage: matter esp commissioning [dump|clear]\n");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t count = s_timeline_count;
+    uint32_t first = count > TIMELINE_COUNT ? count - TIMELINE_COUNT : 0;
+    for (uint32_t id = first; id < count; id++) {
+        profiler_timeline_t timeline;
+        taskENTER_CRITICAL(&s_lock);
+        timeline = s_timelines[id % TIMELINE_COUNT];
+        taskEXIT_CRITICAL(&s_lock);
+        if (timeline.id == id) {
+            dump_timeline(&timeline);
+        }
+    }
+    if (count == 0) {
+        printf("No commissioning recorded\n");
+    }
+    return ESP_OK;
+}
+
+esp_err_t app_profiler_register_commands()
+{
+    static const esp_matter::console::command_t command = {
+        .name = "commissioning",
+        .description = "Dump or clear commissioning timelines. Usage: matter esp commissioning [dump|clear]",
+        .handler = app_profiler_command_handler,
+    };
+    return esp_matter::console::add_commands(&command, 1);
+}
+#else
+esp_err_t app_profiler_register_commands()
+{
+    return ESP_OK;
+}
+#endif // CONFIG_ENABLE_CHIP_SHELL
+
+#endif // CONFIG_APP_COMMISSIONING_PROFILER
@@ -0,0 +1,54 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#pragma once
+
+#include <esp_err.h>
+#include <sdkconfig.h>
+
+/** Commissioning steps recorded by the profiler */
+typedef enum {
+    APP_PROFILER_GET_PASSCODE,
+    APP_PROFILER_GET_VERIFIER_BEGIN,
+    APP_PROFILER_GET_VERIFIER_END,
+    APP_PROFILER_WINDOW_OPENED,
+    APP_PROFILER_BLE_CONNECTED,
+    APP_PROFILER_SESSION_STARTED,
+    APP_PROFILER_SESSION_STOPPED,
+    APP_PROFILER_FABRIC_COMMITTED,
+    APP_PROFILER_COMMISSIONING_COMPLETE,
+    APP_PROFILER_FAIL_SAFE_EXPIRED,
+    APP_PROFILER_WINDOW_CLOSED,
+    APP_PROFILER_BLE_DISCONNECTED,
+    APP_PROFILER_BEFORE_BLE_DEINIT,
+    APP_PROFILER_BLE_DEINITIALIZED,
+    APP_PROFILER_EVENT_MAX,
+} app_profiler_event_t;
+
+#if CONFIG_APP_COMMISSIONING_PROFILER
+/** Record a commissioning step
+ *
+ * Stores the time and free heap with the step in the current commissioning timeline. A new timeline is
+ * started when a commissioning window is opened again. Safe to call from any task.
+ *
+ * @param[in] event Commissioning step.
+ */
+void app_profiler_record(app_profiler_event_t event);
+
+/** Register the profiler shell commands
+ *
+ * Adds `matter esp commissioning [dump|clear]` to dump the kept timelines as a per-phase breakdown.
+ *
+ * @return ESP_OK on success.
+ * @return error in case of failure.
+ */
+esp_err_t app_profiler_register_commands();
+#else
+static inline void app_profiler_record(app_profiler_event_t event) {}
+static inline esp_err_t app_profiler_register_commands() { return ESP_OK; }
+#endif
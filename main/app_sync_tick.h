@@ -0,0 +1,39 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/* Tick grid arithmetic of app_driver_sync_defer(). Free of ESP-IDF dependencies so that tools/sync_test
+ * runs the same scheduling code for several lights against one simulated clock. */
+
+/** First boundary of the tick grid strictly after `ref_us`
+ *
+ * @param[in] ref_us Reference clock time in us, non-negative.
+ * @param[in] tick_us Tick period in us.
+ *
+ * @return Reference clock time of the boundary.
+ */
+static inline int64_t app_sync_next_boundary(int64_t ref_us, int64_t tick_us)
+{
+    return (ref_us / tick_us + 1) * tick_us;
+}
+
+/** Local time of the first grid boundary strictly after `local_us`
+ *
+ * @param[in] local_us Local (esp_timer) time in us.
+ * @param[in] offset_us Reference clock time minus local time.
+ * @param[in] tick_us Tick period in us.
+ *
+ * @return Local time at which the reference clock crosses the boundary.
+ */
+static inline int64_t app_sync_next_local_boundary(int64_t local_us, int64_t offset_us, int64_t tick_us)
+{
+    return app_sync_next_boundary(local_us + offset_us, tick_us) - offset_us;
+}
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <app_profiler.h>
 #include <crypto/CHIPCryptoPAL.h>
 #include <custom_provider/dynamic_commissionable_data_provider.h>
 #include <esp_log.h>
@@ -82,6 +83,7 @@ CHIP_ERROR dynamic_commissionable_data_provider::GetSpake2pVerifier(MutableByteS
     uint32_t iterationCount = 0;
     uint8_t salt[Crypto::kSpake2p_Max_PBKDF_Salt_Length] = {0};
     chip::MutableByteSpan saltSpan(salt, Crypto::kSpake2p_Max_PBKDF_Salt_Length);
+    app_profiler_record(APP_PROFILER_GET_VERIFIER_BEGIN);
     ReturnErrorOnFailure(GetSetupPasscode(setupPasscode));
     ReturnErrorOnFailure(GetSpake2pIterationCount(iterationCount));
     ReturnErrorOnFailure(GetSpake2pSalt(saltSpan));
@@ -89,11 +91,13 @@ CHIP_ERROR dynamic_commissionable_data_provider::GetSpake2pVerifier(MutableByteS
     ReturnErrorOnFailure(verifier.Generate(iterationCount, saltSpan, setupPasscode));
     ReturnErrorOnFailure(verifier.Serialize(verifierBuf));
     verifierLen = verifierBuf.size();
+    app_profiler_record(APP_PROFILER_GET_VERIFIER_END);
     return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR dynamic_commissionable_data_provider::GetSetupPasscode(uint32_t &setupPasscode)
 {
+    app_profiler_record(APP_PROFILER_GET_PASSCODE);
     if (mSetupPasscode == 0) {
         // Check if a fixed passcode is configured
         uint32_t configuredPasscode = CONFIG_DYNAMIC_PASSCODE_PROVIDER_PASSCODE;
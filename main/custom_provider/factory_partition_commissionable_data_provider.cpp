@@ -0,0 +1,276 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#include <sdkconfig.h>
+
+#if CONFIG_FACTORY_PARTITION_COMMISSIONABLE_DATA_PROVIDER
+
+#include <app_profiler.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <custom_provider/factory_partition_commissionable_data_provider.h>
+#include <esp_log.h>
+#include <esp_rom_crc.h>
+#include <lib/support/Base64.h>
+#include <setup_payload/SetupPayload.h>
+#include <string.h>
+
+using namespace ::chip;
+using namespace fctry_nvs;
+
+static const char *TAG = "fctry_provider";
+
+static bool key_equals(const entry_t *entry, const char *key)
+{
+    return strncmp(entry->key, key, k_key_size) == 0;
+}
+
+static bool page_is_readable(const uint8_t *page)
+{
+    const page_header_t *header = reinterpret_cast<const page_header_t *>(page);
+    if (header->state != k_page_state_active && header->state != k_page_state_full) {
+        return false;
+    }
+    return header->version == k_page_version && page_header_crc32(*header, esp_rom_crc32_le) == header->crc32;
+}
+
+static bool entry_is_valid(const uint8_t *page, size_t index)
+{
+    const entry_t *entry = page_entry(page, index);
+    return entry_state(page, index) == k_entry_state_written && entry->span >= 1 &&
+        index + entry->span <= k_entries_per_page && entry_crc32(*entry, esp_rom_crc32_le) == entry->crc32;
+}
+
+/* Variable length entries are followed by their payload entries, which must not be parsed as entries */
+static size_t entry_step(const uint8_t *page, size_t index)
+{
+    return entry_is_valid(page, index) ? page_entry(page, index)->span : 1;
+}
+
+void factory_partition_commissionable_data_provider::ScanPartition(const uint8_t *base, size_t size)
+{
+    int ns_index = -1;
+    for (size_t offset = 0; offset + k_page_size <= size && ns_index < 0; offset += k_page_size) {
+        const uint8_t *page = base + offset;
+        if (!page_is_readable(page)) {
+            continue;
+        }
+        for (size_t i = 0; i < k_entries_per_page; i += entry_step(page, i)) {
+            const entry_t *entry = page_entry(page, i);
+            if (entry_is_valid(page, i) && entry->ns_index == k_namespace_index_root && entry->type == k_type_u8 &&
+                key_equals(entry, k_namespace)) {
+                ns_index = entry->data.raw[0];
+                break;
+            }
+        }
+    }
+    if (ns_index < 0) {
+        return;
+    }
+
+    uint8_t salt_chunks = 0;
+    uint8_t verifier_chunks = 0;
+    for (size_t offset = 0; offset + k_page_size <= size; offset += k_page_size) {
+        const uint8_t *page = base + offset;
+        if (!page_is_readable(page)) {
+            continue;
+        }
+        for (size_t i = 0; i < k_entries_per_page; i += entry_step(page, i)) {
+            const entry_t *entry = page_entry(page, i);
+            if (!entry_is_valid(page, i) || entry->ns_index != ns_index) {
+                continue;
+            }
+
+            /* Integers must be u32 and byte strings str or blob, anything else is ignored */
+            mapped_value *value = nullptr;
+            uint8_t *chunks = nullptr;
+            if (key_equals(entry, k_key_discriminator)) {
+                value = &mDiscriminator;
+            } else if (key_equals(entry, k_key_iteration_count)) {
+                value = &mIterationCount;
+            } else if (key_equals(entry, k_key_passcode)) {
+                value = &mPasscode;
+            } else if (key_equals(entry, k_key_salt)) {
+                value = &mSalt;
+                chunks = &salt_chunks;
+            } else if (key_equals(entry, k_key_verifier)) {
+                value = &mVerifier;
+                chunks = &verifier_chunks;
+            } else {
+                continue;
+            }
+            bool is_integer = !chunks;
+
+            if (is_integer && entry->type == k_type_u32 && entry->span == 1) {
+                value->type = entry->type;
+                value->data = entry->data.raw;
+                value->size = sizeof(uint32_t);
+            } else if (!is_integer &&
+                       (entry->type == k_type_str || (entry->type == k_type_blob_data && entry->chunk_index == 0)) &&
+                       entry->data.var_length.size <= (entry->span - 1) * k_entry_size) {
+                const uint8_t *data = reinterpret_cast<const uint8_t *>(entry + 1);
+                if (esp_rom_crc32_le(k_crc32_init, data, entry->data.var_length.size) ==
+                    entry->data.var_length.data_crc32) {
+                    value->type = entry->type;
+                    value->data = data;
+                    value->size = entry->data.var_length.size;
+                }
+            } else if (!is_integer && entry->type == k_type_blob_idx) {
+                *chunks = entry->data.blob_index.chunk_count;
+            }
+        }
+    }
+
+    /* Blobs split over several pages cannot be served from one contiguous region */
+    if (mSalt.type == k_type_blob_data && salt_chunks != 1) {
+        mSalt = mapped_value();
+    }
+    if (mVerifier.type == k_type_blob_data && verifier_chunks != 1) {
+        mVerifier = mapped_value();
+    }
+}
+
+bool factory_partition_commissionable_data_provider::HasFactoryRecord()
+{
+    if (mScanned) {
+        return mHasRecord;
+    }
+    mScanned = true;
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS,
+                                                                CONFIG_FACTORY_PARTITION_LABEL);
+    if (!partition) {
+        ESP_LOGW(TAG, "Partition %s not found, using Kconfig values", CONFIG_FACTORY_PARTITION_LABEL);
+        return false;
+    }
+    const void *base = nullptr;
+    esp_err_t err = esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &base, &mMapHandle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map partition %s, err:%d", partition->label, err);
+        return false;
+    }
+
+    ScanPartition(static_cast<const uint8_t *>(base), partition->size);
+
+    uint32_t iterations = 0;
+    if (mIterationCount.data) {
+        memcpy(&iterations, mIterationCount.data, sizeof(iterations));
+    }
+    size_t salt_len = DecodedSize(mSalt);
+    mHasRecord = mDiscriminator.data && mSalt.data && mVerifier.data &&
+        iterations >= Crypto::kSpake2p_Min_PBKDF_Iterations && iterations <= Crypto::kSpake2p_Max_PBKDF_Iterations &&
+        salt_len >= Crypto::kSpake2p_Min_PBKDF_Salt_Length && salt_len <= Crypto::kSpake2p_Max_PBKDF_Salt_Length &&
+        DecodedSize(mVerifier) == Crypto::kSpake2p_VerifierSerialized_Length;
+    if (!mHasRecord) {
+        ESP_LOGI(TAG, "No commissionable data in partition %s, using Kconfig values", partition->label);
+        esp_partition_munmap(mMapHandle);
+        mDiscriminator = mIterationCount = mSalt = mVerifier = mPasscode = mapped_value();
+        return false;
+    }
+    ESP_LOGI(TAG, "Using commissionable data from partition %s", partition->label);
+    return true;
+}
+
+size_t factory_partition_commissionable_data_provider::DecodedSize(const mapped_value &value)
+{
+    if (value.type == k_type_blob_data) {
+        return value.size;
+    }
+    if (value.type != k_type_str) {
+        return 0;
+    }
+    /* Base64 strings as written by the esp-matter mfg_tool */
+    const char *b64 = reinterpret_cast<const char *>(value.data);
+    size_t b64Len = strnlen(b64, value.size);
+    if (b64Len == 0 || b64Len % 4 != 0) {
+        return 0;
+    }
+    size_t padding = (b64[b64Len - 1] == '=') + (b64[b64Len - 2] == '=');
+    return b64Len / 4 * 3 - padding;
+}
+
+CHIP_ERROR factory_partition_commissionable_data_provider::ReadBytes(const mapped_value &value, MutableByteSpan &buf)
+{
+    size_t size = DecodedSize(value);
+    ReturnErrorCodeIf(size == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    ReturnErrorCodeIf(size > buf.size(), CHIP_ERROR_BUFFER_TOO_SMALL);
+    if (value.type == k_type_blob_data) {
+        memcpy(buf.data(), value.data, size);
+        buf.reduce_size(size);
+        return CHIP_NO_ERROR;
+    }
+
+    /* Decoded straight into the caller's buffer */
+    const char *b64 = reinterpret_cast<const char *>(value.data);
+    uint32_t b64Len = static_cast<uint32_t>(strnlen(b64, value.size));
+    uint32_t len = chip::Base64Decode32(b64, b64Len, buf.data());
+    ReturnErrorCodeIf(len == UINT32_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+    buf.reduce_size(len);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR factory_partition_commissionable_data_provider::GetSetupDiscriminator(uint16_t &setupDiscriminator)
+{
+    if (!HasFactoryRecord()) {
+        return dynamic_commissionable_data_provider::GetSetupDiscriminator(setupDiscriminator);
+    }
+    uint32_t discriminator = 0;
+    memcpy(&discriminator, mDiscriminator.data, sizeof(discriminator));
+    ReturnErrorCodeIf(discriminator > kMaxDiscriminatorValue, CHIP_ERROR_INVALID_ARGUMENT);
+    setupDiscriminator = static_cast<uint16_t>(discriminator);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR factory_partition_commissionable_data_provider::GetSpake2pIterationCount(uint32_t &iterationCount)
+{
+    if (!HasFactoryRecord()) {
+        return dynamic_commissionable_data_provider::GetSpake2pIterationCount(iterationCount);
+    }
+    memcpy(&iterationCount, mIterationCount.data, sizeof(iterationCount));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR factory_partition_commissionable_data_provider::GetSpake2pSalt(MutableByteSpan &saltBuf)
+{
+    if (!HasFactoryRecord()) {
+        return dynamic_commissionable_data_provider::GetSpake2pSalt(saltBuf);
+    }
+    ReturnErrorOnFailure(ReadBytes(mSalt, saltBuf));
+    ReturnErrorCodeIf(saltBuf.size() < Crypto::kSpake2p_Min_PBKDF_Salt_Length, CHIP_ERROR_INVALID_ARGUMENT);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR factory_partition_commissionable_data_provider::GetSpake2pVerifier(MutableByteSpan &verifierBuf,
+                                                                               size_t &verifierLen)
+{
+    if (!HasFactoryRecord()) {
+        return dynamic_commissionable_data_provider::GetSpake2pVerifier(verifierBuf, verifierLen);
+    }
+    app_profiler_record(APP_PROFILER_GET_VERIFIER_BEGIN);
+    ReturnErrorOnFailure(ReadBytes(mVerifier, verifierBuf));
+    verifierLen = verifierBuf.size();
+    app_profiler_record(APP_PROFILER_GET_VERIFIER_END);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR factory_partition_commissionable_data_provider::GetSetupPasscode(uint32_t &setupPasscode)
+{
+    if (!HasFactoryRecord()) {
+        return dynamic_commissionable_data_provider::GetSetupPasscode(setupPasscode);
+    }
+    app_profiler_record(APP_PROFILER_GET_PASSCODE);
+    /* The passcode only lives in the partition when the provisioning tool was asked to store it. A
+     * generated passcode would not match the stored verifier, so never fall back here. */
+    ReturnErrorCodeIf(!mPasscode.data, CHIP_ERROR_NOT_IMPLEMENTED);
+    uint32_t passcode = 0;
+    memcpy(&passcode, mPasscode.data, sizeof(passcode));
+    ReturnErrorCodeIf(!chip::SetupPayload::IsValidSetupPIN(passcode), CHIP_ERROR_INVALID_ARGUMENT);
+    setupPasscode = passcode;
+    return CHIP_NO_ERROR;
+}
+
+#endif // CONFIG_FACTORY_PARTITION_COMMISSIONABLE_DATA_PROVIDER
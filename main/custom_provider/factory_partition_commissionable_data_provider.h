@@ -0,0 +1,53 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#pragma once
+
+#include <custom_provider/dynamic_commissionable_data_provider.h>
+#include <custom_provider/fctry_nvs_format.h>
+#include <esp_partition.h>
+
+/** Commissionable data provider backed by the `fctry` partition
+ *
+ * The partition is memory-mapped read-only and the discriminator, iteration count, salt and precomputed
+ * SPAKE2+ verifier are served straight from the mapped NVS entries, so no PBKDF2 runs on the device.
+ * If the partition does not hold a complete record, every getter falls back to the Kconfig based
+ * `dynamic_commissionable_data_provider`.
+ */
+class factory_partition_commissionable_data_provider : public dynamic_commissionable_data_provider {
+public:
+    factory_partition_commissionable_data_provider()
+        : dynamic_commissionable_data_provider() {}
+
+    CHIP_ERROR GetSetupDiscriminator(uint16_t &setupDiscriminator) override;
+    CHIP_ERROR GetSpake2pIterationCount(uint32_t &iterationCount) override;
+    CHIP_ERROR GetSpake2pSalt(MutableByteSpan &saltBuf) override;
+    CHIP_ERROR GetSpake2pVerifier(MutableByteSpan &verifierBuf, size_t &verifierLen) override;
+    CHIP_ERROR GetSetupPasscode(uint32_t &setupPasscode) override;
+private:
+    /** A value inside the mapped partition. `data` points into flash, it is never copied. */
+    struct mapped_value {
+        uint8_t type = 0;
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+    };
+
+    bool HasFactoryRecord();
+    void ScanPartition(const uint8_t *base, size_t size);
+    size_t DecodedSize(const mapped_value &value);
+    CHIP_ERROR ReadBytes(const mapped_value &value, MutableByteSpan &buf);
+
+    bool mScanned = false;
+    bool mHasRecord = false;
+    esp_partition_mmap_handle_t mMapHandle = 0;
+    mapped_value mDiscriminator;
+    mapped_value mIterationCount;
+    mapped_value mSalt;
+    mapped_value mVerifier;
+    mapped_value mPasscode;
+};
@@ -0,0 +1,115 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** On-flash layout of an NVS (format version 2) partition, as far as it is needed to read or write the
+ * commissionable data in the `fctry` partition. This header has no ESP-IDF dependency so that the host
+ * provisioning tool and the firmware agree on a single definition.
+ */
+namespace fctry_nvs {
+
+constexpr size_t k_page_size = 4096;
+constexpr size_t k_entry_size = 32;
+constexpr size_t k_entries_per_page = 126;
+constexpr size_t k_bitmap_offset = 32;
+constexpr size_t k_bitmap_size = 32;
+constexpr size_t k_first_entry_offset = 64;
+constexpr size_t k_key_size = 16;
+
+constexpr uint32_t k_page_state_active = 0xFFFFFFFE;
+constexpr uint32_t k_page_state_full = 0xFFFFFFFC;
+constexpr uint8_t k_page_version = 0xFE;
+
+constexpr uint8_t k_entry_state_empty = 0x3;
+constexpr uint8_t k_entry_state_written = 0x2;
+
+constexpr uint8_t k_type_u8 = 0x01;
+constexpr uint8_t k_type_u32 = 0x04;
+constexpr uint8_t k_type_str = 0x21;
+constexpr uint8_t k_type_blob_data = 0x42;
+constexpr uint8_t k_type_blob_idx = 0x48;
+
+constexpr uint8_t k_chunk_index_any = 0xFF;
+constexpr uint8_t k_namespace_index_root = 0;
+
+/** Namespace and keys used by the CHIP ESP32 factory data provider */
+constexpr const char *k_namespace = "chip-factory";
+constexpr const char *k_key_discriminator = "discriminator";
+constexpr const char *k_key_iteration_count = "iteration-count";
+constexpr const char *k_key_salt = "salt";
+constexpr const char *k_key_verifier = "verifier";
+constexpr const char *k_key_passcode = "pin-code";
+
+struct page_header_t {
+    uint32_t state;
+    uint32_t seq_number;
+    uint8_t version;
+    uint8_t reserved[19];
+    uint32_t crc32;
+};
+static_assert(sizeof(page_header_t) == 32, "NVS page header must be 32 bytes");
+
+struct entry_t {
+    uint8_t ns_index;
+    uint8_t type;
+    uint8_t span;
+    uint8_t chunk_index;
+    uint32_t crc32;
+    char key[k_key_size];
+    union {
+        uint8_t raw[8];
+        struct {
+            uint16_t size;
+            uint16_t reserved;
+            uint32_t data_crc32;
+        } var_length;
+        struct {
+            uint32_t size;
+            uint8_t chunk_count;
+            uint8_t chunk_start;
+            uint16_t reserved;
+        } blob_index;
+    } data;
+};
+static_assert(sizeof(entry_t) == k_entry_size, "NVS entry must be 32 bytes");
+
+/** CRC32 with the semantics of `esp_rom_crc32_le()` / `zlib.crc32()` */
+typedef uint32_t (*crc32_fn_t)(uint32_t crc, const uint8_t *buf, uint32_t len);
+
+constexpr uint32_t k_crc32_init = 0xFFFFFFFF;
+
+inline uint32_t page_header_crc32(const page_header_t &header, crc32_fn_t crc32)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&header);
+    return crc32(k_crc32_init, p + offsetof(page_header_t, seq_number),
+                 offsetof(page_header_t, crc32) - offsetof(page_header_t, seq_number));
+}
+
+inline uint32_t entry_crc32(const entry_t &entry, crc32_fn_t crc32)
+{
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&entry);
+    uint32_t crc = crc32(k_crc32_init, p, offsetof(entry_t, crc32));
+    crc = crc32(crc, p + offsetof(entry_t, key), k_key_size);
+    return crc32(crc, p + offsetof(entry_t, data), sizeof(entry.data));
+}
+
+inline uint8_t entry_state(const uint8_t *page, size_t index)
+{
+    return (page[k_bitmap_offset + index / 4] >> ((index % 4) * 2)) & 0x3;
+}
+
+inline const entry_t *page_entry(const uint8_t *page, size_t index)
+{
+    return reinterpret_cast<const entry_t *>(page + k_first_entry_offset + index * k_entry_size);
+}
+
+} // namespace fctry_nvs
@@ -0,0 +1,334 @@
+#!/usr/bin/env python3
+#
+#   This example code is in the Public Domain (or CC0 licensed, at your option.)
+#
+#   Unless required by applicable law or agreed to in writing, this
+#   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+#   CONDITIONS OF ANY KIND, either express or implied.
+#
+"""Multi-subscriber load test for the light endpoint.
+
+Starts a Matter light on the Linux platform (connectedhomeip `chip-lighting-app`),
+commissions it into several fabrics from local controllers, opens N concurrent
+subscriptions to OnOff/CurrentLevel and drives OnOff/MoveToLevel commands at a
+configurable rate. For every (N, rate) step it reports p50/p99 write-to-report
+latency, missed reports, dropped subscriptions and peak RSS of the light process.
+
+`chip-lighting-app` is not configured like endpoint 1 of `app_main`. The
+attributes in APP_MAIN_ATTRIBUTES are read after commissioning and every
+difference is printed. It also cannot be checked over Matter that `app_main`
+marks CurrentLevel, CurrentX, CurrentY and ColorTemperatureMireds for deferred
+persistence, which the Linux app does not have. Latencies
+under load are therefore not directly those of the ESP32 light.
+
+Written against the python controller of connectedhomeip v1.4 (`chip` package
+built from the v1.4 branch), where CommissionOnNetwork and
+OpenCommissioningWindow are coroutines. Older controllers are rejected at start.
+"""
+
+import argparse
+import asyncio
+import inspect
+import os
+import random
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+from dataclasses import dataclass, field
+
+import chip.CertificateAuthority
+import chip.clusters as Clusters
+import chip.native
+from chip.ChipDeviceCtrl import ChipDeviceController, DiscoveryFilterType
+from chip.clusters.Attribute import ValueDecodeFailure
+from chip.ChipStack import ChipStack
+
+LIGHT_ENDPOINT = 1
+DEVICE_NODE_ID = 0x1234
+VENDOR_ID = 0xFFF1
+
+ON_OFF = Clusters.OnOff.Attributes.OnOff
+CURRENT_LEVEL = Clusters.LevelControl.Attributes.CurrentLevel
+EXECUTE_IF_OFF = 0x01
+COLOR_MODE_COLOR_TEMPERATURE = 2
+
+# Endpoint 1 of app_main at boot (main/app_main.cpp, DEFAULT_* in main/app_priv.h). ABSENT marks attributes
+# app_main does not create.
+ABSENT = 'absent'
+APP_MAIN_ATTRIBUTES = [
+    (Clusters.OnOff, Clusters.OnOff.Attributes.OnOff, True),
+    (Clusters.OnOff, Clusters.OnOff.Attributes.StartUpOnOff, ABSENT),
+    (Clusters.LevelControl, CURRENT_LEVEL, 64),
+    (Clusters.LevelControl, Clusters.LevelControl.Attributes.OnLevel, 64),
+    (Clusters.LevelControl, Clusters.LevelControl.Attributes.StartUpCurrentLevel, 64),
+    (Clusters.ColorControl, Clusters.ColorControl.Attributes.ColorMode, COLOR_MODE_COLOR_TEMPERATURE),
+    (Clusters.ColorControl, Clusters.ColorControl.Attributes.StartUpColorTemperatureMireds, ABSENT),
+]
+
+
+@dataclass
+class StepResult:
+    subscriptions: int
+    rate: float
+    writes: int = 0
+    latencies_ms: list = field(default_factory=list)
+    expected_reports: int = 0
+    dropped_subscriptions: int = 0
+    peak_rss_kb: int = 0
+
+
+class LightProcess:
+    """The Linux light app under test, with RSS sampling from /proc."""
+
+    def __init__(self, app_path, discriminator, passcode, workdir):
+        self.kvs = os.path.join(workdir, 'light.kvs')
+        cmd = [app_path, '--discriminator', str(discriminator), '--passcode', str(passcode), '--KVS', self.kvs]
+        self.log = open(os.path.join(workdir, 'light.log'), 'w')
+        self.proc = subprocess.Popen(cmd, stdout=self.log, stderr=subprocess.STDOUT)
+        self.peak_rss_kb = 0
+
+    def sample_rss(self):
+        try:
+            with open(f'/proc/{self.proc.pid}/status') as f:
+                for line in f:
+                    if line.startswith('VmRSS:'):
+                        rss = int(line.split()[1])
+                        self.peak_rss_kb = max(self.peak_rss_kb, rss)
+                        return rss
+        except FileNotFoundError:
+            pass
+        return 0
+
+    def reset_peak(self):
+        self.peak_rss_kb = 0
+        self.sample_rss()
+
+    def stop(self):
+        self.proc.send_signal(signal.SIGTERM)
+        try:
+            self.proc.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            self.proc.kill()
+        self.log.close()
+
+
+class Subscriber:
+    """One subscription on one fabric; matches every report to the write that caused it.
+
+    Writes of one attribute are reported in order, so each report is matched to the oldest write of that
+    attribute with the reported value that this subscriber has not seen yet. Writes skipped over were
+    coalesced away by the report engine and count as missed reports.
+    """
+
+    def __init__(self, writes, result):
+        self.writes = writes
+        self.result = result
+        self.transaction = None
+        self.dropped = False
+        self.cursor = {ON_OFF: 0, CURRENT_LEVEL: 0}
+
+    def on_report(self, path, transaction):
+        now = time.monotonic()
+        attribute = path.AttributeType
+        if attribute not in self.cursor:
+            return
+        value = transaction.GetAttribute(path)
+        history = self.writes[attribute]
+        for index in range(self.cursor[attribute], len(history)):
+            written, sent = history[index]
+            if written == value:
+                self.result.latencies_ms.append((now - sent) * 1000.0)
+                self.cursor[attribute] = index + 1
+                return
+
+    def on_resubscribe(self, transaction, termination_error, next_interval_ms):
+        if not self.dropped:
+            self.dropped = True
+            self.result.dropped_subscriptions += 1
+
+    def on_error(self, error, transaction):
+        self.on_resubscribe(transaction, error, 0)
+
+
+def percentile(values, pct):
+    if not values:
+        return float('nan')
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, max(0, int(round(pct / 100.0 * len(ordered))) - 1))
+    return ordered[index]
+
+
+async def commission_fabrics(stack, fabrics, discriminator, passcode):
+    ca_manager = chip.CertificateAuthority.CertificateAuthorityManager(chipStack=stack)
+    ca_manager.LoadAuthoritiesFromStorage()
+    ca = ca_manager.NewCertificateAuthority()
+
+    controllers = []
+    for index in range(fabrics):
+        admin = ca.NewFabricAdmin(vendorId=VENDOR_ID, fabricId=index + 1)
+        controllers.append(admin.NewController(nodeId=112233 + index))
+
+    await controllers[0].CommissionOnNetwork(nodeId=DEVICE_NODE_ID, setupPinCode=passcode,
+                                             filterType=DiscoveryFilterType.LONG_DISCRIMINATOR, filter=discriminator)
+    for index, ctrl in enumerate(controllers[1:], start=1):
+        window_discriminator = random.randint(0, 4095)
+        params = await controllers[0].OpenCommissioningWindow(nodeid=DEVICE_NODE_ID, timeout=180, iteration=1000,
+                                                              discriminator=window_discriminator, option=1)
+        await ctrl.CommissionOnNetwork(nodeId=DEVICE_NODE_ID, setupPinCode=params.setupPinCode,
+                                       filterType=DiscoveryFilterType.LONG_DISCRIMINATOR, filter=window_discriminator)
+        print(f'Commissioned fabric {index + 1}/{fabrics}')
+    return controllers
+
+
+def same_value(actual, expected):
+    if actual is ABSENT or expected is ABSENT:
+        return actual is expected
+    try:
+        return int(actual) == int(expected)
+    except TypeError:
+        return False  # null
+
+
+async def report_config_differences(ctrl):
+    """Print every attribute of APP_MAIN_ATTRIBUTES on which the light under test differs from app_main."""
+    data = await ctrl.ReadAttribute(DEVICE_NODE_ID, [(LIGHT_ENDPOINT, attribute) for _, attribute, _ in
+                                                     APP_MAIN_ATTRIBUTES])
+    differences = []
+    for cluster, attribute, expected in APP_MAIN_ATTRIBUTES:
+        actual = data.get(LIGHT_ENDPOINT, {}).get(cluster, {}).get(attribute, ABSENT)
+        if isinstance(actual, ValueDecodeFailure):
+            actual = ABSENT
+        if not same_value(actual, expected):
+            differences.append((f'{cluster.__name__}.{attribute.__name__}', expected, actual))
+    if not differences:
+        print('Light configuration matches app_main on the checked attributes')
+        return
+    print('Light configuration differs from app_main:')
+    for name, expected, actual in differences:
+        print(f'  {name}: app_main {expected}, light under test {actual}')
+
+
+async def run_step(controllers, light, subscriptions, rate, duration, onoff_ratio):
+    result = StepResult(subscriptions=subscriptions, rate=rate)
+    writes = {ON_OFF: [], CURRENT_LEVEL: []}
+    subscribers = []
+
+    for index in range(subscriptions):
+        ctrl = controllers[index % len(controllers)]
+        subscriber = Subscriber(writes, result)
+        subscriber.transaction = await ctrl.ReadAttribute(
+            DEVICE_NODE_ID, [(LIGHT_ENDPOINT, ON_OFF), (LIGHT_ENDPOINT, CURRENT_LEVEL)], reportInterval=(0, 30),
+            keepSubscriptions=True, autoResubscribe=True)
+        subscriber.transaction.SetAttributeUpdateCallback(subscriber.on_report)
+        subscriber.transaction.SetResubscriptionAttemptedCallback(subscriber.on_resubscribe)
+        subscriber.transaction.SetErrorCallback(subscriber.on_error)
+        subscribers.append(subscriber)
+
+    writer = controllers[0]
+    # Start from the actual state so every command below changes it and must be reported.
+    state = await writer.ReadAttribute(DEVICE_NODE_ID, [(LIGHT_ENDPOINT, ON_OFF), (LIGHT_ENDPOINT, CURRENT_LEVEL)])
+    on_off = state[LIGHT_ENDPOINT][Clusters.OnOff][ON_OFF]
+    level = state[LIGHT_ENDPOINT][Clusters.LevelControl][CURRENT_LEVEL] or 1
+    light.reset_peak()
+    interval = 1.0 / rate
+    start = time.monotonic()
+    next_write = start
+    while time.monotonic() - start < duration:
+        if random.random() < onoff_ratio:
+            on_off = not on_off
+            attribute, value = ON_OFF, on_off
+            command = Clusters.OnOff.Commands.On() if on_off else Clusters.OnOff.Commands.Off()
+        else:
+            level = level % 254 + 1
+            attribute, value = CURRENT_LEVEL, level
+            # ExecuteIfOff, so level commands still change CurrentLevel while the light is off
+            command = Clusters.LevelControl.Commands.MoveToLevel(level=level, transitionTime=0,
+                                                                 optionsMask=EXECUTE_IF_OFF,
+                                                                 optionsOverride=EXECUTE_IF_OFF)
+        writes[attribute].append((value, time.monotonic()))
+        try:
+            await writer.SendCommand(DEVICE_NODE_ID, LIGHT_ENDPOINT, command)
+            result.writes += 1
+        except Exception as e:
+            # A failed command changes nothing, so it must not be matched against reports
+            writes[attribute].pop()
+            if attribute is ON_OFF:
+                on_off = not on_off
+            print(f'Write failed: {e}', file=sys.stderr)
+        light.sample_rss()
+        next_write += interval
+        await asyncio.sleep(max(0.0, next_write - time.monotonic()))
+
+    # Let the last reports drain before tearing the subscriptions down.
+    await asyncio.sleep(1.0)
+    light.sample_rss()
+    result.peak_rss_kb = light.peak_rss_kb
+    result.expected_reports = result.writes * subscriptions
+    for subscriber in subscribers:
+        subscriber.transaction.Shutdown()
+    return result
+
+
+def print_report(results):
+    header = f'{"subs":>5} {"rate/s":>7} {"writes":>7} {"p50 ms":>8} {"p99 ms":>8} {"missed":>7} {"dropped":>8} ' \
+             f'{"peak RSS KiB":>13}'
+    print(header)
+    print('-' * len(header))
+    for r in results:
+        missed = max(0, r.expected_reports - len(r.latencies_ms))
+        print(f'{r.subscriptions:>5} {r.rate:>7.1f} {r.writes:>7} {percentile(r.latencies_ms, 50):>8.1f} '
+              f'{percentile(r.latencies_ms, 99):>8.1f} {missed:>7} {r.dropped_subscriptions:>8} {r.peak_rss_kb:>13}')
+
+
+def parse_list(text, cast):
+    return [cast(item) for item in text.split(',') if item]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Multi-subscriber load test for the light endpoint')
+    parser.add_argument('--app', required=True, help='Path to the Linux chip-lighting-app binary')
+    parser.add_argument('--fabrics', type=int, default=3, help='Number of controller fabrics to commission')
+    parser.add_argument('--subscriptions', default='1,3,6,9', help='Comma separated total subscription counts')
+    parser.add_argument('--rates', default='1,5,10,20', help='Comma separated write rates (commands/second)')
+    parser.add_argument('--duration', type=float, default=20.0, help='Seconds per (subscriptions, rate) step')
+    parser.add_argument('--onoff-ratio', type=float, default=0.2, help='Fraction of writes that are OnOff commands')
+    parser.add_argument('--discriminator', type=int, default=3840)
+    parser.add_argument('--passcode', type=int, default=20202021)
+    args = parser.parse_args()
+
+    if not inspect.iscoroutinefunction(ChipDeviceController.CommissionOnNetwork):
+        sys.exit('This script needs the connectedhomeip v1.4 python controller (async CommissionOnNetwork)')
+
+    workdir = tempfile.mkdtemp(prefix='light_load_test_')
+    light = LightProcess(args.app, args.discriminator, args.passcode, workdir)
+    time.sleep(2)
+
+    chip.native.Init()
+    stack = ChipStack(persistentStoragePath=os.path.join(workdir, 'controller.json'), enableServerInteractions=False)
+
+    async def run():
+        controllers = await commission_fabrics(stack, args.fabrics, args.discriminator, args.passcode)
+        await report_config_differences(controllers[0])
+        results = []
+        for subscriptions in parse_list(args.subscriptions, int):
+            for rate in parse_list(args.rates, float):
+                print(f'Running {subscriptions} subscriptions at {rate} writes/s for {args.duration}s')
+                results.append(await run_step(controllers, light, subscriptions, rate, args.duration,
+                                              args.onoff_ratio))
+        print_report(results)
+        for ctrl in controllers:
+            ctrl.Shutdown()
+
+    try:
+        asyncio.run(run())
+    finally:
+        stack.Shutdown()
+        light.stop()
+        shutil.rmtree(workdir, ignore_errors=True)
+
+
+if __name__ == '__main__':
+    main()
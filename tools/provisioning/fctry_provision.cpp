@@ -0,0 +1,269 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/* Generates a production batch of per-device commissionable data: a unique passcode, salt and SPAKE2+
+ * verifier for every device, written as a ready-to-flash `fctry` NVS image plus a CSV manifest. Devices are
+ * generated in parallel on all cores.
+ *
+ *   fctry_provision --count 1000 --out batch/ [--iterations 10000] [--jobs N] [--store-passcode]
+ *   esptool.py write_flash 0x3E0000 batch/fctry-00000.bin
+ */
+
+#include <nvs_image.h>
+#include <spake2p_verifier.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace fctry_nvs;
+
+struct provision_config {
+    size_t count = 0;
+    std::string out_dir;
+    uint32_t iterations = 10000;
+    size_t salt_len = k_spake2p_max_salt_length;
+    size_t partition_size = 0x6000;
+    unsigned jobs = 0;
+    bool store_passcode = false;
+};
+
+struct device_record {
+    uint16_t discriminator = 0;
+    uint32_t passcode = 0;
+    uint8_t salt[k_spake2p_max_salt_length] = {0};
+    uint8_t verifier[k_spake2p_verifier_length] = {0};
+    bool ok = false;
+};
+
+static std::string image_name(size_t index)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "fctry-%05zu.bin", index);
+    return name;
+}
+
+static std::string base64(const uint8_t *data, size_t len)
+{
+    std::string out(4 * ((len + 2) / 3) + 1, '\0');
+    int written = EVP_EncodeBlock(reinterpret_cast<unsigned char *>(&out[0]), data, static_cast<int>(len));
+    out.resize(written);
+    return out;
+}
+
+static bool write_image(const provision_config &config, size_t index, const device_record &record)
+{
+    nvs_image image(config.partition_size);
+    bool ok = image.add_namespace(k_namespace) && image.add_u32(k_key_discriminator, record.discriminator) &&
+        image.add_u32(k_key_iteration_count, config.iterations) &&
+        image.add_blob(k_key_salt, record.salt, config.salt_len) &&
+        image.add_blob(k_key_verifier, record.verifier, sizeof(record.verifier));
+    if (ok && config.store_passcode) {
+        ok = image.add_u32(k_key_passcode, record.passcode);
+    }
+    if (!ok) {
+        return false;
+    }
+
+    std::string path = config.out_dir + "/" + image_name(index);
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    ok = fwrite(image.data().data(), 1, image.data().size(), file) == image.data().size();
+    return fclose(file) == 0 && ok;
+}
+
+static bool provision_device(const provision_config &config, size_t index, device_record &record)
+{
+    uint8_t discriminator[2];
+    if (RAND_bytes(discriminator, sizeof(discriminator)) != 1 || RAND_bytes(record.salt, config.salt_len) != 1 ||
+        !generate_random_passcode(record.passcode)) {
+        return false;
+    }
+    record.discriminator = (discriminator[0] | (discriminator[1] << 8)) & 0xFFF;
+    return generate_spake2p_verifier(record.passcode, record.salt, config.salt_len, config.iterations,
+                                     record.verifier) &&
+        write_image(config, index, record);
+}
+
+/* Passcodes are drawn independently per device, so a batch can repeat one. Give every repeat a passcode
+ * not used in the batch yet and rebuild its verifier and image; `redrawn` receives the number replaced. */
+static bool make_passcodes_unique(const provision_config &config, std::vector<device_record> &records,
+                                  size_t &redrawn)
+{
+    std::unordered_set<uint32_t> used;
+    std::vector<size_t> duplicates;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (!used.insert(records[i].passcode).second) {
+            duplicates.push_back(i);
+        }
+    }
+    for (size_t index : duplicates) {
+        device_record &record = records[index];
+        do {
+            if (!generate_random_passcode(record.passcode)) {
+                return false;
+            }
+        } while (!used.insert(record.passcode).second);
+        if (!generate_spake2p_verifier(record.passcode, record.salt, config.salt_len, config.iterations,
+                                       record.verifier) ||
+            !write_image(config, index, record)) {
+            return false;
+        }
+    }
+    redrawn = duplicates.size();
+    return true;
+}
+
+static bool write_manifest(const provision_config &config, const std::vector<device_record> &records)
+{
+    std::string path = config.out_dir + "/manifest.csv";
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "index,discriminator,passcode,iterations,salt,verifier,image\n");
+    for (size_t i = 0; i < records.size(); ++i) {
+        const device_record &record = records[i];
+        fprintf(file, "%zu,%u,%08u,%u,%s,%s,%s\n", i, record.discriminator, record.passcode, config.iterations,
+                base64(record.salt, config.salt_len).c_str(),
+                base64(record.verifier, sizeof(record.verifier)).c_str(), image_name(i).c_str());
+    }
+    return fclose(file) == 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s --count N --out DIR [options]\n"
+            "  --count N            Number of devices to generate\n"
+            "  --out DIR            Output directory for the images and manifest.csv\n"
+            "  --iterations N       PBKDF2 iterations (%u-%u, default 10000)\n"
+            "  --salt-len N         Salt length in bytes (%zu-%zu, default %zu)\n"
+            "  --partition-size N   fctry partition size in bytes (default 0x6000)\n"
+            "  --jobs N             Worker threads (default: all cores)\n"
+            "  --store-passcode     Also store the passcode (pin-code) in the image\n",
+            prog, k_spake2p_min_iterations, k_spake2p_max_iterations, k_spake2p_min_salt_length,
+            k_spake2p_max_salt_length, k_spake2p_max_salt_length);
+}
+
+static bool parse_args(int argc, char **argv, provision_config &config)
+{
+    static const struct option options[] = {
+        {"count", required_argument, nullptr, 'c'},
+        {"out", required_argument, nullptr, 'o'},
+        {"iterations", required_argument, nullptr, 'i'},
+        {"salt-len", required_argument, nullptr, 's'},
+        {"partition-size", required_argument, nullptr, 'p'},
+        {"jobs", required_argument, nullptr, 'j'},
+        {"store-passcode", no_argument, nullptr, 'P'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "c:o:i:s:p:j:P", options, nullptr)) != -1) {
+        switch (opt) {
+        case 'c':
+            config.count = strtoul(optarg, nullptr, 0);
+            break;
+        case 'o':
+            config.out_dir = optarg;
+            break;
+        case 'i':
+            config.iterations = strtoul(optarg, nullptr, 0);
+            break;
+        case 's':
+            config.salt_len = strtoul(optarg, nullptr, 0);
+            break;
+        case 'p':
+            config.partition_size = strtoul(optarg, nullptr, 0);
+            break;
+        case 'j':
+            config.jobs = strtoul(optarg, nullptr, 0);
+            break;
+        case 'P':
+            config.store_passcode = true;
+            break;
+        default:
+            return false;
+        }
+    }
+    return config.count > 0 && !config.out_dir.empty() && config.iterations >= k_spake2p_min_iterations &&
+        config.iterations <= k_spake2p_max_iterations && config.salt_len >= k_spake2p_min_salt_length &&
+        config.salt_len <= k_spake2p_max_salt_length && config.partition_size >= 2 * k_page_size;
+}
+
+int main(int argc, char **argv)
+{
+    provision_config config;
+    if (!parse_args(argc, argv, config)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (config.jobs == 0) {
+        config.jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (mkdir(config.out_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        perror(config.out_dir.c_str());
+        return 1;
+    }
+
+    std::vector<device_record> records(config.count);
+    std::atomic<size_t> next_index(0);
+    std::atomic<size_t> failures(0);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned j = 0; j < config.jobs; ++j) {
+        workers.emplace_back([&] {
+            size_t index;
+            while ((index = next_index++) < config.count) {
+                records[index].ok = provision_device(config, index, records[index]);
+                if (!records[index].ok) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (failures > 0) {
+        fprintf(stderr, "Failed to provision %zu of %zu devices\n", failures.load(), config.count);
+        return 1;
+    }
+    size_t redrawn = 0;
+    if (!make_passcodes_unique(config, records, redrawn)) {
+        fprintf(stderr, "Failed to replace duplicate passcodes\n");
+        return 1;
+    }
+    if (redrawn > 0) {
+        printf("Replaced %zu duplicate passcodes\n", redrawn);
+    }
+    if (!write_manifest(config, records)) {
+        fprintf(stderr, "Failed to write manifest\n");
+        return 1;
+    }
+    printf("Provisioned %zu devices in %.2f s with %u jobs (%.1f devices/s, %u iterations)\n", config.count, elapsed,
+           config.jobs, config.count / elapsed, config.iterations);
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#include <nvs_image.h>
+
+#include <string.h>
+
+using namespace fctry_nvs;
+
+uint32_t nvs_crc32(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    static uint32_t table[256];
+    static const bool table_ready = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)table_ready;
+
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; ++i) {
+        crc = table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+nvs_image::nvs_image(size_t partition_size)
+    : m_buf(partition_size / k_page_size * k_page_size, 0xFF)
+{
+    if (m_buf.size() >= 2 * k_page_size) {
+        start_page();
+    }
+}
+
+void nvs_image::start_page()
+{
+    page_header_t *header = reinterpret_cast<page_header_t *>(&m_buf[m_page * k_page_size]);
+    header->state = k_page_state_active;
+    header->seq_number = static_cast<uint32_t>(m_page);
+    header->version = k_page_version;
+    header->crc32 = page_header_crc32(*header, nvs_crc32);
+}
+
+bool nvs_image::reserve_entries(size_t count)
+{
+    /* The last page stays erased so the NVS library always has a spare page */
+    size_t page_count = m_buf.size() / k_page_size;
+    if (page_count < 2 || count > k_entries_per_page) {
+        return false;
+    }
+    if (m_entry + count <= k_entries_per_page) {
+        return true;
+    }
+    if (m_page + 2 >= page_count) {
+        return false;
+    }
+    reinterpret_cast<page_header_t *>(&m_buf[m_page * k_page_size])->state = k_page_state_full;
+    ++m_page;
+    m_entry = 0;
+    start_page();
+    return true;
+}
+
+entry_t *nvs_image::next_entry(uint8_t ns_index, uint8_t type, uint8_t span, uint8_t chunk_index, const char *key)
+{
+    entry_t *entry = reinterpret_cast<entry_t *>(&m_buf[m_page * k_page_size + k_first_entry_offset +
+                                                         m_entry * k_entry_size]);
+    entry->ns_index = ns_index;
+    entry->type = type;
+    entry->span = span;
+    entry->chunk_index = chunk_index;
+    memset(entry->key, 0, k_key_size);
+    strncpy(entry->key, key, k_key_size - 1);
+    return entry;
+}
+
+void nvs_image::commit_entry(entry_t *entry)
+{
+    entry->crc32 = entry_crc32(*entry, nvs_crc32);
+    uint8_t *bitmap = &m_buf[m_page * k_page_size + k_bitmap_offset];
+    for (size_t i = m_entry; i < m_entry + entry->span; ++i) {
+        /* EMPTY (0b11) -> WRITTEN (0b10) */
+        bitmap[i / 4] &= ~(1 << ((i % 4) * 2));
+    }
+    m_entry += entry->span;
+}
+
+bool nvs_image::add_namespace(const char *name)
+{
+    if (strlen(name) >= k_key_size || !reserve_entries(1)) {
+        return false;
+    }
+    entry_t *entry = next_entry(k_namespace_index_root, k_type_u8, 1, k_chunk_index_any, name);
+    entry->data.raw[0] = ++m_ns_count;
+    commit_entry(entry);
+    m_ns_index = m_ns_count;
+    return true;
+}
+
+bool nvs_image::add_u32(const char *key, uint32_t value)
+{
+    if (m_ns_index == 0 || strlen(key) >= k_key_size || !reserve_entries(1)) {
+        return false;
+    }
+    entry_t *entry = next_entry(m_ns_index, k_type_u32, 1, k_chunk_index_any, key);
+    memcpy(entry->data.raw, &value, sizeof(value));
+    commit_entry(entry);
+    return true;
+}
+
+bool nvs_image::add_blob(const char *key, const uint8_t *data, size_t size)
+{
+    size_t payload_entries = (size + k_entry_size - 1) / k_entry_size;
+    /* Data entry, its payload and the index entry are kept on one page */
+    if (m_ns_index == 0 || strlen(key) >= k_key_size || !reserve_entries(payload_entries + 2)) {
+        return false;
+    }
+
+    entry_t *entry = next_entry(m_ns_index, k_type_blob_data, static_cast<uint8_t>(payload_entries + 1), 0, key);
+    entry->data.var_length.size = static_cast<uint16_t>(size);
+    entry->data.var_length.reserved = 0xFFFF;
+    entry->data.var_length.data_crc32 = nvs_crc32(k_crc32_init, data, static_cast<uint32_t>(size));
+    memcpy(entry + 1, data, size);
+    commit_entry(entry);
+
+    entry = next_entry(m_ns_index, k_type_blob_idx, 1, k_chunk_index_any, key);
+    entry->data.blob_index.size = static_cast<uint32_t>(size);
+    entry->data.blob_index.chunk_count = 1;
+    entry->data.blob_index.chunk_start = 0;
+    entry->data.blob_index.reserved = 0xFFFF;
+    commit_entry(entry);
+    return true;
+}
@@ -0,0 +1,47 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#pragma once
+
+#include <custom_provider/fctry_nvs_format.h>
+
+#include <stdint.h>
+#include <vector>
+
+/** Minimal writer for NVS (format version 2) partition images
+ *
+ * Produces the same layout as ESP-IDF's `nvs_partition_gen.py` for the entry types used in the
+ * `chip-factory` namespace. Blobs are always written as a single chunk, so the firmware can serve them
+ * straight from the memory-mapped partition. The last page is left erased, as the NVS library requires.
+ */
+class nvs_image {
+public:
+    explicit nvs_image(size_t partition_size);
+
+    /** Start a namespace; following values are written into it */
+    bool add_namespace(const char *name);
+    bool add_u32(const char *key, uint32_t value);
+    bool add_blob(const char *key, const uint8_t *data, size_t size);
+
+    const std::vector<uint8_t> &data() const { return m_buf; }
+
+private:
+    bool reserve_entries(size_t count);
+    fctry_nvs::entry_t *next_entry(uint8_t ns_index, uint8_t type, uint8_t span, uint8_t chunk_index, const char *key);
+    void commit_entry(fctry_nvs::entry_t *entry);
+    void start_page();
+
+    std::vector<uint8_t> m_buf;
+    size_t m_page = 0;
+    size_t m_entry = 0;
+    uint8_t m_ns_index = 0;
+    uint8_t m_ns_count = 0;
+};
+
+/** CRC32 with the semantics of `esp_rom_crc32_le()` */
+uint32_t nvs_crc32(uint32_t crc, const uint8_t *buf, uint32_t len);
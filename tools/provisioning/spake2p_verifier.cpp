@@ -0,0 +1,87 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#include <spake2p_verifier.h>
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/rand.h>
+
+#include <memory>
+
+/** Length of each of w0s and w1s: the P-256 group order size plus 64 bits, to keep the modular bias low */
+constexpr size_t k_spake2p_ws_length = 40;
+constexpr size_t k_p256_fe_length = 32;
+constexpr size_t k_p256_point_length = 65;
+
+bool is_valid_setup_pin(uint32_t passcode)
+{
+    if (passcode == 0 || passcode > k_setup_passcode_max || passcode == 11111111 || passcode == 22222222 ||
+        passcode == 33333333 || passcode == 44444444 || passcode == 55555555 || passcode == 66666666 ||
+        passcode == 77777777 || passcode == 88888888 || passcode == 12345678 || passcode == 87654321) {
+        return false;
+    }
+    return true;
+}
+
+bool generate_random_passcode(uint32_t &passcode)
+{
+    if (RAND_bytes(reinterpret_cast<uint8_t *>(&passcode), sizeof(passcode)) != 1) {
+        return false;
+    }
+    passcode = (passcode % k_setup_passcode_max) + 1;
+    if (!is_valid_setup_pin(passcode)) {
+        passcode = passcode + 1;
+    }
+    return true;
+}
+
+bool generate_spake2p_verifier(uint32_t passcode, const uint8_t *salt, size_t salt_len, uint32_t iterations,
+                               uint8_t *verifier)
+{
+    if (salt_len < k_spake2p_min_salt_length || salt_len > k_spake2p_max_salt_length ||
+        iterations < k_spake2p_min_iterations || iterations > k_spake2p_max_iterations) {
+        return false;
+    }
+
+    /* The passcode is fed to PBKDF2 as a little-endian 32-bit integer */
+    uint8_t password[4] = {
+        static_cast<uint8_t>(passcode), static_cast<uint8_t>(passcode >> 8), static_cast<uint8_t>(passcode >> 16),
+        static_cast<uint8_t>(passcode >> 24),
+    };
+    uint8_t ws[2 * k_spake2p_ws_length];
+    if (PKCS5_PBKDF2_HMAC(reinterpret_cast<const char *>(password), sizeof(password), salt, static_cast<int>(salt_len),
+                          static_cast<int>(iterations), EVP_sha256(), sizeof(ws), ws) != 1) {
+        return false;
+    }
+
+    std::unique_ptr<EC_GROUP, decltype(&EC_GROUP_free)> group(EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1),
+                                                              EC_GROUP_free);
+    std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)> ctx(BN_CTX_new(), BN_CTX_free);
+    std::unique_ptr<BIGNUM, decltype(&BN_free)> w0(BN_bin2bn(ws, k_spake2p_ws_length, nullptr), BN_free);
+    std::unique_ptr<BIGNUM, decltype(&BN_free)> w1(BN_bin2bn(ws + k_spake2p_ws_length, k_spake2p_ws_length, nullptr),
+                                                   BN_free);
+    if (!group || !ctx || !w0 || !w1) {
+        return false;
+    }
+    std::unique_ptr<EC_POINT, decltype(&EC_POINT_free)> L(EC_POINT_new(group.get()), EC_POINT_free);
+    const BIGNUM *order = EC_GROUP_get0_order(group.get());
+    if (!L || BN_nnmod(w0.get(), w0.get(), order, ctx.get()) != 1 ||
+        BN_nnmod(w1.get(), w1.get(), order, ctx.get()) != 1 ||
+        EC_POINT_mul(group.get(), L.get(), w1.get(), nullptr, nullptr, ctx.get()) != 1) {
+        return false;
+    }
+
+    if (BN_bn2binpad(w0.get(), verifier, k_p256_fe_length) != k_p256_fe_length) {
+        return false;
+    }
+    return EC_POINT_point2oct(group.get(), L.get(), POINT_CONVERSION_UNCOMPRESSED, verifier + k_p256_fe_length,
+                              k_p256_point_length, ctx.get()) == k_p256_point_length;
+}
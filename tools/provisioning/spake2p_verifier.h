@@ -0,0 +1,39 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Sizes from chip/crypto/CHIPCryptoPAL.h */
+constexpr size_t k_spake2p_min_salt_length = 16;
+constexpr size_t k_spake2p_max_salt_length = 32;
+constexpr uint32_t k_spake2p_min_iterations = 1000;
+constexpr uint32_t k_spake2p_max_iterations = 100000;
+constexpr size_t k_spake2p_verifier_length = 97;
+constexpr uint32_t k_setup_passcode_max = 99999998;
+
+/** Same rules as `chip::SetupPayload::IsValidSetupPIN()` */
+bool is_valid_setup_pin(uint32_t passcode);
+
+/** Random passcode, picked the way `dynamic_commissionable_data_provider::GenerateRandomPasscode()` does
+ *
+ * @return false if the random generator failed.
+ */
+bool generate_random_passcode(uint32_t &passcode);
+
+/** Serialized SPAKE2+ verifier (w0 || L), identical to `chip::Crypto::Spake2pVerifier::Generate()` followed
+ * by `Serialize()` on the P-256 implementation.
+ *
+ * @param[out] verifier Buffer of `k_spake2p_verifier_length` bytes.
+ *
+ * @return false on invalid arguments or crypto failure.
+ */
+bool generate_spake2p_verifier(uint32_t passcode, const uint8_t *salt, size_t salt_len, uint32_t iterations,
+                               uint8_t *verifier);
@@ -0,0 +1,85 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/* Parity checks of the host-side SPAKE2+ code against connectedhomeip: the test verifier of
+ * CHIP_DEVICE_CONFIG_USE_TEST_SPAKE2P_VERIFIER and the passcodes rejected by `SetupPayload::IsValidSetupPIN()`.
+ */
+
+#include <spake2p_verifier.h>
+
+#include <openssl/evp.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+/* src/include/platform/CHIPDeviceConfig.h */
+static const uint32_t k_test_passcode = 20202021;
+static const char *k_test_salt = "SPAKE2P Key Salt";
+static const uint32_t k_test_iterations = 1000;
+static const char *k_test_verifier = "uWFwqugDNGiEck/po7KHwwMwwqZgN10XuyBajPGuyzUEV/iree4lOrao5GuwnlQ65CJzbeUB49s31EH+NE"
+                                     "kg0JVI5MGCQGMMT/SRPFNRODm3wH/MBiehuFc6FJ/NH6Rmzw==";
+
+/* src/setup_payload/SetupPayload.cpp */
+static const uint32_t k_invalid_passcodes[] = {
+    0,        11111111, 22222222, 33333333, 44444444, 55555555, 66666666,
+    77777777, 88888888, 99999999, 12345678, 87654321, 100000000,
+};
+static const uint32_t k_valid_passcodes[] = {1, 20202021, 99999998};
+
+static int s_failures = 0;
+
+static void check(bool condition, const char *what)
+{
+    if (!condition) {
+        printf("FAIL: %s\n", what);
+        s_failures++;
+    }
+}
+
+static std::string base64(const uint8_t *data, size_t len)
+{
+    std::string out(4 * ((len + 2) / 3) + 1, '\0');
+    int written = EVP_EncodeBlock(reinterpret_cast<unsigned char *>(&out[0]), data, static_cast<int>(len));
+    out.resize(written);
+    return out;
+}
+
+int main()
+{
+    uint8_t verifier[k_spake2p_verifier_length];
+    bool generated = generate_spake2p_verifier(k_test_passcode, reinterpret_cast<const uint8_t *>(k_test_salt),
+                                               strlen(k_test_salt), k_test_iterations, verifier);
+    check(generated, "test verifier generation");
+    if (generated) {
+        std::string encoded = base64(verifier, sizeof(verifier));
+        check(encoded == k_test_verifier, "test verifier matches CHIP");
+        printf("verifier %s\n", encoded.c_str());
+    }
+
+    for (uint32_t passcode : k_invalid_passcodes) {
+        char what[64];
+        snprintf(what, sizeof(what), "passcode %u rejected", passcode);
+        check(!is_valid_setup_pin(passcode), what);
+    }
+    for (uint32_t passcode : k_valid_passcodes) {
+        char what[64];
+        snprintf(what, sizeof(what), "passcode %u accepted", passcode);
+        check(is_valid_setup_pin(passcode), what);
+    }
+    for (int i = 0; i < 100000; i++) {
+        uint32_t passcode = 0;
+        if (!generate_random_passcode(passcode) || !is_valid_setup_pin(passcode)) {
+            check(false, "random passcode valid");
+            break;
+        }
+    }
+
+    printf("%s\n", s_failures ? "FAIL" : "PASS");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,264 @@
+/*
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/* Runs the tick alignment of app_driver_sync_defer() (main/app_sync_tick.h) for several lights against one
+ * simulated true clock, and compares the group start skew with applying updates on arrival. Every light
+ * has its own boot time, crystal drift and SNTP error and resyncs its offset periodically; every group
+ * command reaches each light with independent arrival jitter.
+ *
+ * Alignment trades the spread of the arrivals for a two-valued skew: lights that pick the same boundary
+ * start within the clock error, but a group whose arrivals straddle a boundary, a fraction of about
+ * arrival spread / tick of all commands at any tick size, starts one tick apart. The test asserts the
+ * clock error bound, the one tick bound over all trials, that straddling matches the arrival spread, and
+ * that the median skew beats the unsynchronized baseline.
+ *
+ *   sync_skew_test [--lights N] [--trials N] [--tick-ms N] [--jitter-ms N] [--drift-ppm N]
+ *                  [--sntp-error-us N] [--interval-s N] [--seed N]
+ */
+
+#include <app_sync_tick.h>
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+struct test_config {
+    unsigned lights = 8;
+    unsigned trials = 20000;
+    int64_t tick_us = 50000;
+    int64_t jitter_us = 20000;
+    double drift_ppm = 40;
+    int64_t sntp_error_us = 1000;
+    int64_t interval_us = 60 * 1000000LL;
+    int64_t timer_lateness_us = 500;
+    unsigned seed = 1;
+};
+
+/* One light: local clock `local = (t - boot) * (1 + drift)`, offset refreshed on every SNTP sync */
+struct light {
+    int64_t boot_us;
+    double drift;
+    int64_t sync_phase_us;
+    int64_t last_sync_us = -1;
+    int64_t offset_us = 0;
+
+    int64_t local_time(int64_t true_us) const
+    {
+        return static_cast<int64_t>(llround((true_us - boot_us) * (1.0 + drift)));
+    }
+
+    int64_t true_time(int64_t local_us) const
+    {
+        return static_cast<int64_t>(llround(local_us / (1.0 + drift))) + boot_us;
+    }
+
+    /* Same as app_driver_sync_time_cb(): reference time as reported by SNTP minus local time */
+    void sync_until(int64_t true_us, const test_config &config, std::mt19937_64 &rng)
+    {
+        std::uniform_int_distribution<int64_t> error(-config.sntp_error_us, config.sntp_error_us);
+        int64_t sync_us = true_us - (true_us - sync_phase_us) % config.interval_us;
+        if (sync_us != last_sync_us) {
+            last_sync_us = sync_us;
+            offset_us = sync_us + error(rng) - local_time(sync_us);
+        }
+    }
+};
+
+struct skew_stats {
+    size_t count = 0;
+    int64_t p50_us = 0;
+    int64_t p99_us = 0;
+    int64_t max_us = 0;
+};
+
+static skew_stats summarize(std::vector<int64_t> skews)
+{
+    skew_stats stats;
+    if (skews.empty()) {
+        return stats;
+    }
+    std::sort(skews.begin(), skews.end());
+    stats.count = skews.size();
+    stats.p50_us = skews[skews.size() / 2];
+    stats.p99_us = skews[skews.size() * 99 / 100];
+    stats.max_us = skews.back();
+    return stats;
+}
+
+static void print_stats(const char *name, const skew_stats &stats)
+{
+    printf("  %-16s %8zu %10ld %10ld %10ld\n", name, stats.count, (long)stats.p50_us, (long)stats.p99_us,
+           (long)stats.max_us);
+}
+
+static bool parse_args(int argc, char **argv, test_config &config)
+{
+    static const struct option options[] = {
+        {"lights", required_argument, nullptr, 'l'},
+        {"trials", required_argument, nullptr, 't'},
+        {"tick-ms", required_argument, nullptr, 'k'},
+        {"jitter-ms", required_argument, nullptr, 'j'},
+        {"drift-ppm", required_argument, nullptr, 'd'},
+        {"sntp-error-us", required_argument, nullptr, 'e'},
+        {"interval-s", required_argument, nullptr, 'i'},
+        {"seed", required_argument, nullptr, 's'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "l:t:k:j:d:e:i:s:", options, nullptr)) != -1) {
+        switch (opt) {
+        case 'l':
+            config.lights = strtoul(optarg, nullptr, 0);
+            break;
+        case 't':
+            config.trials = strtoul(optarg, nullptr, 0);
+            break;
+        case 'k':
+            config.tick_us = strtoll(optarg, nullptr, 0) * 1000;
+            break;
+        case 'j':
+            config.jitter_us = strtoll(optarg, nullptr, 0) * 1000;
+            break;
+        case 'd':
+            config.drift_ppm = strtod(optarg, nullptr);
+            break;
+        case 'e':
+            config.sntp_error_us = strtoll(optarg, nullptr, 0);
+            break;
+        case 'i':
+            config.interval_us = strtoll(optarg, nullptr, 0) * 1000000;
+            break;
+        case 's':
+            config.seed = strtoul(optarg, nullptr, 0);
+            break;
+        default:
+            return false;
+        }
+    }
+    return config.lights >= 2 && config.trials > 0 && config.tick_us > 0 && config.jitter_us >= 0 &&
+        config.interval_us > 0 && config.sntp_error_us >= 0;
+}
+
+int main(int argc, char **argv)
+{
+    test_config config;
+    if (!parse_args(argc, argv, config)) {
+        fprintf(stderr, "Usage: %s [--lights N] [--trials N] [--tick-ms N] [--jitter-ms N] [--drift-ppm N] "
+                        "[--sntp-error-us N] [--interval-s N] [--seed N]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(config.seed);
+    std::uniform_int_distribution<int64_t> boot(0, 10 * 1000000LL);
+    std::uniform_real_distribution<double> drift(-config.drift_ppm * 1e-6, config.drift_ppm * 1e-6);
+    std::uniform_int_distribution<int64_t> phase(0, config.interval_us - 1);
+    std::uniform_int_distribution<int64_t> jitter(0, config.jitter_us);
+    std::uniform_int_distribution<int64_t> lateness(0, config.timer_lateness_us);
+    std::uniform_int_distribution<int64_t> gap(config.tick_us, 10 * config.interval_us);
+
+    std::vector<light> lights;
+    for (unsigned i = 0; i < config.lights; ++i) {
+        lights.push_back({boot(rng), drift(rng), phase(rng)});
+    }
+
+    /* Each light's offset is off by at most the SNTP error plus the drift since its last sync, and its
+     * timer may fire late. Two lights on the same boundary can differ by both lights' errors. */
+    double offset_error_bound = config.sntp_error_us + config.drift_ppm * 1e-6 * config.interval_us * 1.01 + 2;
+    int64_t same_tick_bound = static_cast<int64_t>(2 * offset_error_bound) + config.timer_lateness_us;
+
+    int64_t now_us = 20 * 1000000LL + config.interval_us;
+    unsigned straddled = 0;
+    double ref_spread_sum_us = 0;
+    std::vector<int64_t> sync_skews;
+    std::vector<int64_t> same_tick_skews;
+    std::vector<int64_t> baseline_skews;
+    for (unsigned trial = 0; trial < config.trials; ++trial) {
+        now_us += gap(rng);
+        int64_t first_start = INT64_MAX;
+        int64_t last_start = INT64_MIN;
+        int64_t first_direct = INT64_MAX;
+        int64_t last_direct = INT64_MIN;
+        int64_t first_ref = INT64_MAX;
+        int64_t last_ref = INT64_MIN;
+        int64_t first_boundary = INT64_MAX;
+        int64_t last_boundary = INT64_MIN;
+        for (light &l : lights) {
+            int64_t arrival_us = now_us + jitter(rng);
+            l.sync_until(arrival_us, config, rng);
+            /* Same as app_driver_sync_defer() and the esp_timer it starts */
+            int64_t local_us = l.local_time(arrival_us);
+            int64_t fire_local_us = app_sync_next_local_boundary(local_us, l.offset_us, config.tick_us);
+            int64_t boundary_us = fire_local_us + l.offset_us;
+            int64_t start_us = l.true_time(fire_local_us) + lateness(rng);
+            /* Without synchronized transitions the update is applied on arrival */
+            int64_t direct_us = arrival_us + lateness(rng);
+            first_start = std::min(first_start, start_us);
+            last_start = std::max(last_start, start_us);
+            first_direct = std::min(first_direct, direct_us);
+            last_direct = std::max(last_direct, direct_us);
+            first_ref = std::min(first_ref, local_us + l.offset_us);
+            last_ref = std::max(last_ref, local_us + l.offset_us);
+            first_boundary = std::min(first_boundary, boundary_us);
+            last_boundary = std::max(last_boundary, boundary_us);
+        }
+        int64_t skew_us = last_start - first_start;
+        sync_skews.push_back(skew_us);
+        baseline_skews.push_back(last_direct - first_direct);
+        ref_spread_sum_us += last_ref - first_ref;
+        if (first_boundary == last_boundary) {
+            same_tick_skews.push_back(skew_us);
+        } else {
+            straddled++;
+        }
+    }
+
+    skew_stats sync = summarize(sync_skews);
+    skew_stats same_tick = summarize(same_tick_skews);
+    skew_stats baseline = summarize(baseline_skews);
+    /* A group straddles a boundary when one falls between its earliest and latest arrival on the reference
+     * clock, whatever the tick size */
+    double straddle_fraction = static_cast<double>(straddled) / config.trials;
+    double expected_straddle_fraction = std::min(1.0, ref_spread_sum_us / config.trials / config.tick_us);
+
+    printf("%u lights, %u trials, tick %ld ms, jitter %ld ms, drift %.0f ppm, SNTP error %ld us, resync %ld s\n",
+           config.lights, config.trials, (long)(config.tick_us / 1000), (long)(config.jitter_us / 1000),
+           config.drift_ppm, (long)config.sntp_error_us, (long)(config.interval_us / 1000000));
+    printf("  %-16s %8s %10s %10s %10s\n", "group start skew", "trials", "p50 (us)", "p99 (us)", "max (us)");
+    print_stats("unsynchronized", baseline);
+    print_stats("synchronized", sync);
+    print_stats("  same tick", same_tick);
+    printf("  adjacent ticks in %.1f%% of the trials (arrival spread / tick predicts %.1f%%), same tick bound %ld us\n",
+           100 * straddle_fraction, 100 * expected_straddle_fraction, (long)same_tick_bound);
+
+    bool ok = true;
+    if (same_tick.max_us > same_tick_bound || same_tick.max_us >= config.tick_us) {
+        printf("FAIL: lights on the same tick started %ld us apart\n", (long)same_tick.max_us);
+        ok = false;
+    }
+    if (sync.max_us > config.tick_us + same_tick_bound) {
+        printf("FAIL: synchronized group started %ld us apart, more than one tick plus the clock error\n",
+               (long)sync.max_us);
+        ok = false;
+    }
+    if (fabs(straddle_fraction - expected_straddle_fraction) > 0.01 + 0.1 * expected_straddle_fraction) {
+        printf("FAIL: adjacent tick fraction %.3f does not match the arrival spread\n", straddle_fraction);
+        ok = false;
+    }
+    if (sync.p50_us >= baseline.p50_us) {
+        printf("FAIL: synchronized median skew %ld us is not below the unsynchronized %ld us\n",
+               (long)sync.p50_us, (long)baseline.p50_us);
+        ok = false;
+    }
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}